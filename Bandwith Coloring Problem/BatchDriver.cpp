@@ -0,0 +1,107 @@
+#include "BatchDriver.h"
+
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+
+BatchDriver::BatchDriver(int NoThreads, int NoOutputThreads, size_t OutputCapacity)
+    : Pool(NoThreads), Output(OutputCapacity, NoOutputThreads)
+{
+}
+//------------------------------------------------------------------------------------------------
+
+void BatchDriver::Add(std::unique_ptr<BatchJob> Job)
+{
+    Jobs.push_back(std::move(Job));
+}
+//------------------------------------------------------------------------------------------------
+
+void BatchDriver::Run()
+{
+    for (auto& Job : Jobs)
+        ScheduleLoad(*Job);
+
+    Pool.Wait();
+    Output.Drain();
+    Jobs.clear();
+}
+//------------------------------------------------------------------------------------------------
+
+std::vector<std::string> BatchDriver::ListInstances(const std::string& InstancesPath, const std::string& Extension)
+{
+    std::vector<std::string> FileNames;
+    for (const auto& entry : std::filesystem::directory_iterator(InstancesPath)) {
+        if (entry.is_regular_file() && (Extension.empty() || entry.path().extension() == Extension)) {
+            FileNames.push_back(entry.path().string());
+        }
+    }
+
+    std::sort(FileNames.begin(), FileNames.end());
+    return FileNames;
+}
+//------------------------------------------------------------------------------------------------
+
+void BatchDriver::ScheduleLoad(BatchJob& Job)
+{
+    Pool.Submit([this, &Job]() {
+        try
+        {
+            Job.Load(Pool);
+        }
+        catch (const std::exception& Ex)
+        {
+            Report(Job, "load", Ex);
+            return;
+        }
+        ScheduleReplicas(Job);
+    });
+}
+//------------------------------------------------------------------------------------------------
+
+void BatchDriver::ScheduleReplicas(BatchJob& Job)
+{
+    auto WriteOutput = [this, &Job]() {
+        Output.Push([this, &Job]() {
+            try
+            {
+                Job.WriteOutput();
+            }
+            catch (const std::exception& Ex)
+            {
+                Report(Job, "output", Ex);
+            }
+        });
+    };
+
+    int NoReplicas = Job.NoReplicas();
+    if (NoReplicas == 0)
+    {
+        WriteOutput();
+        return;
+    }
+
+    auto Remaining = std::make_shared<std::atomic<int>>(NoReplicas);
+    for (int Replica = 0; Replica < NoReplicas; ++Replica)
+    {
+        Pool.Submit([this, &Job, Replica, Remaining, WriteOutput]() {
+            try
+            {
+                Job.SolveReplica(Replica);
+            }
+            catch (const std::exception& Ex)
+            {
+                Report(Job, "solve", Ex);
+            }
+
+            if (--*Remaining == 0)
+                WriteOutput();
+        });
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+void BatchDriver::Report(const BatchJob& Job, const std::string& Stage, const std::exception& Ex)
+{
+    std::cerr << Job.Name() + " ---> " + Stage + " failed: " + Ex.what() + "\n";
+}
+//------------------------------------------------------------------------------------------------
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <functional>
+
+#include "ThreadPool.h"
+#include "OutputPipeline.h"
+
+// One instance of a batch run. The driver calls Load once, then every replica
+// (possibly concurrently, each replica on its own thread) and WriteOutput after
+// the last replica has finished.
+class BatchJob
+{
+public:
+    virtual ~BatchJob() = default;
+
+    virtual std::string Name() const = 0;
+    virtual void Load(ThreadPool& Pool) = 0;
+    virtual int NoReplicas() const = 0;
+    virtual void SolveReplica(int Replica) = 0;
+    virtual void WriteOutput() = 0;
+};
+
+// Runs a set of jobs as a pipeline (load -> replicas -> output) on one work-stealing
+// pool, so parsing of some instances overlaps with solving of others. The output
+// stage is handed to a separate OutputPipeline so solver threads never do I/O.
+class BatchDriver
+{
+    ThreadPool Pool;
+    OutputPipeline Output;
+    std::vector<std::unique_ptr<BatchJob>> Jobs;
+public:
+    explicit BatchDriver(int NoThreads = 0, int NoOutputThreads = 1, size_t OutputCapacity = 64);
+
+    void Add(std::unique_ptr<BatchJob> Job);
+    void Run();
+    OutputPipeline& GetOutput() { return Output; }
+
+    static std::vector<std::string> ListInstances(const std::string& InstancesPath, const std::string& Extension);
+private:
+    void ScheduleLoad(BatchJob& Job);
+    void ScheduleReplicas(BatchJob& Job);
+    void Report(const BatchJob& Job, const std::string& Stage, const std::exception& Ex);
+};
@@ -0,0 +1,182 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+#include "LPRKernelAccess.h"
+#include "SyntheticGraph.h"
+
+// Checks that the memetic search step does not allocate once it is warmed up: one
+// relinking, the augmented and the plain tabu search and a penalty update run on every
+// storage layout, and every heap allocation after the warm-up step fails the check.
+// Allocations are counted by replacing the global operator new and delete.
+// Usage: AllocationCheck [--steps 5]
+
+namespace
+{
+    // Heap allocations of the calling thread.
+    thread_local int64_t Allocations = 0;
+
+    void* CountedAllocate(std::size_t Size) noexcept
+    {
+        ++Allocations;
+        return std::malloc(Size > 0 ? Size : 1);
+    }
+
+    void* CountedAllocate(std::size_t Size, std::align_val_t Alignment) noexcept
+    {
+        ++Allocations;
+        std::size_t Align = std::max((std::size_t)Alignment, sizeof(void*));
+#ifdef _MSC_VER
+        return _aligned_malloc(Size > 0 ? Size : 1, Align);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment.
+        return std::aligned_alloc(Align, (std::max<std::size_t>(Size, 1) + Align - 1) / Align * Align);
+#endif
+    }
+
+    void CountedFree(void* Memory) noexcept { std::free(Memory); }
+
+    void CountedFree(void* Memory, std::align_val_t) noexcept
+    {
+#ifdef _MSC_VER
+        _aligned_free(Memory);
+#else
+        std::free(Memory);
+#endif
+    }
+
+    template <typename... Alignment>
+    void* CountedAllocateOrThrow(std::size_t Size, Alignment... Align)
+    {
+        if (void* Memory = CountedAllocate(Size, Align...))
+            return Memory;
+        throw std::bad_alloc();
+    }
+}
+
+// The whole replaceable family is routed through the counter, so every form of new
+// is paired with the matching delete whichever one the library picks.
+void* operator new(std::size_t Size) { return CountedAllocateOrThrow(Size); }
+void* operator new[](std::size_t Size) { return CountedAllocateOrThrow(Size); }
+void* operator new(std::size_t Size, std::align_val_t Align) { return CountedAllocateOrThrow(Size, Align); }
+void* operator new[](std::size_t Size, std::align_val_t Align) { return CountedAllocateOrThrow(Size, Align); }
+void* operator new(std::size_t Size, const std::nothrow_t&) noexcept { return CountedAllocate(Size); }
+void* operator new[](std::size_t Size, const std::nothrow_t&) noexcept { return CountedAllocate(Size); }
+void* operator new(std::size_t Size, std::align_val_t Align, const std::nothrow_t&) noexcept { return CountedAllocate(Size, Align); }
+void* operator new[](std::size_t Size, std::align_val_t Align, const std::nothrow_t&) noexcept { return CountedAllocate(Size, Align); }
+
+void operator delete(void* Memory) noexcept { CountedFree(Memory); }
+void operator delete[](void* Memory) noexcept { CountedFree(Memory); }
+void operator delete(void* Memory, std::size_t) noexcept { CountedFree(Memory); }
+void operator delete[](void* Memory, std::size_t) noexcept { CountedFree(Memory); }
+void operator delete(void* Memory, std::align_val_t Align) noexcept { CountedFree(Memory, Align); }
+void operator delete[](void* Memory, std::align_val_t Align) noexcept { CountedFree(Memory, Align); }
+void operator delete(void* Memory, std::size_t, std::align_val_t Align) noexcept { CountedFree(Memory, Align); }
+void operator delete[](void* Memory, std::size_t, std::align_val_t Align) noexcept { CountedFree(Memory, Align); }
+void operator delete(void* Memory, const std::nothrow_t&) noexcept { CountedFree(Memory); }
+void operator delete[](void* Memory, const std::nothrow_t&) noexcept { CountedFree(Memory); }
+void operator delete(void* Memory, std::align_val_t Align, const std::nothrow_t&) noexcept { CountedFree(Memory, Align); }
+void operator delete[](void* Memory, std::align_val_t Align, const std::nothrow_t&) noexcept { CountedFree(Memory, Align); }
+
+namespace
+{
+    const int MaxWeight = 5;
+
+    struct GraphArguments
+    {
+        int NoNodes;
+        double Density;
+        int NoColors;
+    };
+
+    const GraphArguments Graphs[] = { { 100, 0.1, 20 }, { 250, 0.1, 40 }, { 500, 0.05, 60 }, { 1000, 0.01, 250 } };
+
+    template <typename Search>
+    bool CheckLayout(const GraphArguments& Arguments, int NoSteps)
+    {
+        SyntheticGraph Graph(Arguments.NoNodes, Arguments.Density, MaxWeight, 12345);
+        LPRParameters Parameters;
+        Search Solver(Graph.NoNodes, Graph.NoEdges, Arguments.NoColors, Graph.Edges, Parameters, 4242);
+        LPRKernelAccess::SetSearchDepth(Solver, 100, 100);
+
+        std::mt19937 gen(777);
+        auto FirstParent = LPRKernelAccess::Convert<Search>(Graph.RandomSolution(Arguments.NoColors, gen));
+        auto SecondParent = LPRKernelAccess::Convert<Search>(Graph.RandomSolution(Arguments.NoColors, gen));
+        typename Search::SolutionType Child;
+        auto Step = [&]
+        {
+            LPRKernelAccess::MixedPathRelinking(Solver, FirstParent, SecondParent, Child);
+            LPRKernelAccess::TabuSearchImpr(Solver, Child, true);
+            LPRKernelAccess::TabuSearchImpr(Solver, Child, false);
+            LPRKernelAccess::UpdatePenaltyMatrix(Solver, Child);
+        };
+        // After the warm-up step the workspace has all its capacity.
+        Step();
+
+        int64_t Before = Allocations;
+        for (int Index = 0; Index < NoSteps; ++Index)
+            Step();
+        int64_t Allocated = Allocations - Before;
+        if (Allocated > 0)
+        {
+            std::cerr << Solver.Layout() << ", n " << Arguments.NoNodes << ", K " << Arguments.NoColors << ": "
+                << Allocated << " allocations in " << NoSteps << " steady-state steps\n";
+            return false;
+        }
+        return true;
+    }
+
+    template <typename... Layouts>
+    bool CheckLayouts(const GraphArguments& Arguments, int NoSteps)
+    {
+        // Every layout is checked even after a failure, so one run lists all of them.
+        bool Passed = true;
+        ((Passed = CheckLayout<Layouts>(Arguments, NoSteps) && Passed), ...);
+        return Passed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int NoSteps = 5;
+    auto Usage = [&](std::ostream& Out) { Out << "usage: " << argv[0] << " [--steps N]\n"; };
+    for (int Index = 1; Index < argc; Index += 2)
+    {
+        std::string Option = argv[Index];
+        if (Option == "--help" || Option == "-h")
+        {
+            Usage(std::cout);
+            return 0;
+        }
+        if (Option != "--steps" || Index + 1 >= argc)
+        {
+            std::cerr << (Option == "--steps" ? "missing value for " : "unknown option ") << Option << "\n";
+            Usage(std::cerr);
+            return 2;
+        }
+        try
+        {
+            NoSteps = std::max(1, std::stoi(argv[Index + 1]));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "invalid value for " << Option << ": " << argv[Index + 1] << "\n";
+            Usage(std::cerr);
+            return 2;
+        }
+    }
+
+    bool Passed = true;
+    for (const auto& Arguments : Graphs)
+    {
+        Passed = CheckLayouts<LPRSearch<uint8_t, int16_t>, LPRSearch<uint8_t, int32_t>, LPRSearch<uint16_t, int16_t>,
+            LPRSearch<uint16_t, int32_t>, LPRSearch<int32_t, int32_t>>(Arguments, NoSteps) && Passed;
+    }
+    if (!Passed)
+        return 1;
+    std::cout << "no allocations in " << NoSteps << " steady-state steps\n";
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../SolverBenchmark.h"
+
+// End-to-end benchmark over a directory of .col instances.
+// Usage: EndToEnd <instances dir> [--seeds 1,2,3] [--threads 1,4] [--filter GEOM2]
+//                 [--out benchmark.json] [--baseline baseline.json] [--threshold 0.1] [--time-limit 60]
+//                 [--neighbourhood exact|gap]
+// Exits with 1 when a metric regresses past the threshold against the baseline.
+
+namespace
+{
+    template <typename T>
+    std::vector<T> ParseList(const std::string& Text)
+    {
+        std::vector<T> Values;
+        std::stringstream Stream(Text);
+        std::string Item;
+        while (std::getline(Stream, Item, ','))
+            Values.push_back((T)std::stoll(Item));
+        return Values;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <instances dir> [--seeds a,b] [--threads a,b] [--filter text]"
+            << " [--out path] [--baseline path] [--threshold fraction] [--time-limit seconds] [--neighbourhood exact|gap]\n";
+        return 2;
+    }
+
+    BenchmarkConfig Config;
+    Config.InstancesPath = argv[1];
+    for (int Index = 2; Index < argc; Index += 2)
+    {
+        std::string Option = argv[Index];
+        if (Index + 1 == argc)
+        {
+            std::cerr << "missing value for " << Option << "\n";
+            return 2;
+        }
+        std::string Value = argv[Index + 1];
+        if (Option == "--seeds")
+            Config.Seeds = ParseList<unsigned>(Value);
+        else if (Option == "--threads")
+            Config.ThreadCounts = ParseList<int>(Value);
+        else if (Option == "--filter")
+            Config.Filter = Value;
+        else if (Option == "--out")
+            Config.OutputPath = Value;
+        else if (Option == "--baseline")
+            Config.BaselinePath = Value;
+        else if (Option == "--threshold")
+            Config.Threshold = std::stod(Value);
+        else if (Option == "--time-limit")
+            Config.Parameters.TimeLimit = std::stod(Value);
+        else if (Option == "--neighbourhood")
+            Config.Parameters.ExactNeighbourhood = Value != "gap";
+        else
+        {
+            std::cerr << "unknown option " << Option << "\n";
+            return 2;
+        }
+    }
+
+    SolverBenchmark Benchmark(Config);
+    Benchmark.Run();
+    Benchmark.WriteResults();
+    int NoRegressions = Benchmark.CompareToBaseline();
+    if (NoRegressions > 0)
+    {
+        std::cout << NoRegressions << " regression(s) against " << Config.BaselinePath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,524 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "LPRKernelAccess.h"
+#include "../LPR.h"
+#include "SyntheticGraph.h"
+
+// Differential fuzzer of the incremental LPR kernels. Every case builds a random graph and
+// drives the kernels of every storage layout with random solutions and moves, comparing each
+// incremental quantity with a brute-force evaluation on the dense edge matrix:
+//   - plain and augmented cost, and the cost delta of every applied move;
+//   - ColorChangeSum / ColorChangeWeightSum and the conflict set after every move;
+//   - the lazily rescaled edge penalties against an eagerly rescaled dense copy;
+//   - the child of MixedPathRelinking against a brute-force relinking;
+//   - the gap neighbourhood containing a best color of its node.
+// With --solve split it runs LPR::Solve end to end instead, on graphs made of isolated
+// nodes, single edges and larger components under shuffled ids, and checks that the
+// stitched coloring satisfies every edge of the original numbering. --solve peel also
+// hangs chains and trees of low-degree nodes off the components and peels them, and
+// --solve reorder additionally renumbers every searched component in reverse Cuthill-McKee
+// order after checking that the permutation maps every edge back.
+// Usage: KernelFuzz [--cases 200] [--seed 1] [--max-nodes 40] [--solve split|peel|reorder]
+// Stops at the first mismatch and prints the seed of the failing case. Configure with
+// -DBCP_SANITIZE=address,undefined to run it under the sanitizers.
+
+namespace
+{
+    const int MovesPerCase = 60;
+
+    // The original dense formulation of the LPR cost and penalties.
+    struct Reference
+    {
+        const SyntheticGraph& Graph;
+        int MaxPenaltyWeight;
+        float ScalingFactor;
+        std::vector<std::vector<int>> Penalty;
+
+        Reference(const SyntheticGraph& Graph, const LPRParameters& Parameters)
+            : Graph(Graph), MaxPenaltyWeight(Parameters.MaxPenaltyWeight), ScalingFactor(Parameters.ScalingFactor),
+              Penalty(Graph.NoNodes, std::vector<int>(Graph.NoNodes, 0))
+        {
+        }
+
+        template <typename Solution>
+        int Cost(const Solution& S, bool Augmented) const
+        {
+            int Sum = 0;
+            for (int v1 = 0; v1 < Graph.NoNodes; ++v1)
+            {
+                for (int v2 = 0; v2 < v1; ++v2)
+                {
+                    int Slack = Graph.Edges[v1][v2] - std::abs(S[v1] - S[v2]);
+                    Sum += std::max(0, Slack);
+                    if (Augmented && Slack > 0)
+                        Sum += Penalty[v1][v2];
+                }
+            }
+            return Sum;
+        }
+
+        template <typename Solution>
+        void UpdatePenalties(const Solution& S)
+        {
+            int MaxPenalty = 0;
+            for (int v1 = 0; v1 < Graph.NoNodes; ++v1)
+            {
+                for (int v2 = 0; v2 < v1; ++v2)
+                {
+                    if (Graph.Edges[v1][v2] > 0 && std::abs(S[v1] - S[v2]) < Graph.Edges[v1][v2])
+                    {
+                        ++Penalty[v1][v2];
+                        ++Penalty[v2][v1];
+                    }
+                    MaxPenalty = std::max(MaxPenalty, Penalty[v1][v2]);
+                }
+            }
+            if (MaxPenalty <= MaxPenaltyWeight)
+                return;
+            for (auto& Line : Penalty)
+            {
+                for (auto& Value : Line)
+                    Value = (int)std::floor(ScalingFactor * Value);
+            }
+        }
+
+        // Plain and penalty parts of the cost that Node contributes with color NewColor.
+        template <typename Solution>
+        std::pair<int, int> NodeCost(const Solution& S, int Node, int NewColor) const
+        {
+            std::pair<int, int> Result = { 0, 0 };
+            for (int Neighbour = 0; Neighbour < Graph.NoNodes; ++Neighbour)
+            {
+                int Weight = Graph.Edges[Node][Neighbour];
+                if (Weight == 0)
+                    continue;
+                Result.first += std::max(0, Weight - std::abs(S[Neighbour] - NewColor));
+                if (std::abs(S[Neighbour] - NewColor) < Weight)
+                    Result.second += Penalty[Node][Neighbour];
+            }
+            return Result;
+        }
+
+        // MixedPathRelinking on the dense matrix. The kernel keeps the original scoring, in which
+        // a candidate is rated against the neighbours' colors in the parent it is taken from and
+        // the running sums are carried over instead of recomputed.
+        template <typename Solution>
+        Solution Relink(const Solution& FirstParent, const Solution& SecondParent) const
+        {
+            std::vector<int> DiffPos;
+            for (int Index = 0; Index < Graph.NoNodes; ++Index)
+            {
+                if (FirstParent[Index] != SecondParent[Index])
+                    DiffPos.push_back(Index);
+            }
+
+            Solution PrevLast = FirstParent;
+            Solution Last = SecondParent;
+            int SumPrevLast = Cost(PrevLast, false);
+            int SumLast = Cost(Last, false);
+            for (int Step = 0; !DiffPos.empty(); ++Step)
+            {
+                const Solution& Choice = Step % 2 == 0 ? SecondParent : FirstParent;
+                int BestCost = INT_MAX;
+                int BestIndex = 0;
+                for (int Index = 0; Index < (int)DiffPos.size(); ++Index)
+                {
+                    int Node = DiffPos[Index];
+                    int Sum = SumPrevLast;
+                    for (int Neighbour = 0; Neighbour < Graph.NoNodes; ++Neighbour)
+                    {
+                        int Weight = Graph.Edges[Node][Neighbour];
+                        if (Weight == 0)
+                            continue;
+                        Sum += std::max(0, Weight - std::abs(Choice[Node] - Choice[Neighbour]))
+                            - std::max(0, Weight - std::abs(PrevLast[Node] - PrevLast[Neighbour]));
+                    }
+                    if (Sum < BestCost)
+                    {
+                        BestCost = Sum;
+                        BestIndex = Index;
+                    }
+                }
+                Solution Next = PrevLast;
+                Next[DiffPos[BestIndex]] = Choice[DiffPos[BestIndex]];
+                PrevLast = Last;
+                Last = Next;
+                SumPrevLast = SumLast;
+                SumLast = BestCost;
+                DiffPos.erase(DiffPos.begin() + BestIndex);
+            }
+            return Last;
+        }
+    };
+
+    struct Mismatch
+    {
+        std::string What;
+    };
+
+    void Expect(bool Condition, const std::string& What)
+    {
+        if (!Condition)
+            throw Mismatch{ What };
+    }
+
+    template <typename Search>
+    void CheckMatrices(const Reference& Ref, const typename Search::SolutionType& S, typename Search::WorkspaceType& Work, bool Augmented, int NoColors)
+    {
+        for (int Node = 0; Node < (int)S.size(); ++Node)
+        {
+            for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+            {
+                auto Expected = Ref.NodeCost(S, Node, NewColor);
+                Expect(Work.ColorChangeSum[Node][NewColor] == Expected.first,
+                    "ColorChangeSum of node " + std::to_string(Node) + ", color " + std::to_string(NewColor));
+                if (Augmented)
+                    Expect(Work.ColorChangeWeightSum[Node][NewColor] == Expected.second,
+                        "ColorChangeWeightSum of node " + std::to_string(Node) + ", color " + std::to_string(NewColor));
+            }
+        }
+    }
+
+    template <typename Search>
+    void CheckGapColors(Search& Solver, const Reference& Ref, const typename Search::SolutionType& S, typename Search::WorkspaceType& Work, bool Augmented, int Node, int NoColors)
+    {
+        auto Score = [&](int NewColor)
+        {
+            auto Cost = Ref.NodeCost(S, Node, NewColor);
+            return Cost.first + (Augmented ? Cost.second : 0);
+        };
+
+        int Best = INT_MAX;
+        for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+            Best = std::min(Best, Score(NewColor));
+
+        int BestCandidate = INT_MAX;
+        for (int NewColor : LPRKernelAccess::CollectGapColors(Solver, S, Node, Work))
+        {
+            Expect(NewColor >= 1 && NewColor <= NoColors, "gap color out of range at node " + std::to_string(Node));
+            BestCandidate = std::min(BestCandidate, Score(NewColor));
+        }
+        Expect(BestCandidate == Best, "gap neighbourhood misses the best color of node " + std::to_string(Node));
+    }
+
+    template <typename Search>
+    void RunLayout(unsigned Seed, const SyntheticGraph& Graph, int NoColors, const LPRParameters& Parameters)
+    {
+        using SolutionType = typename Search::SolutionType;
+        std::mt19937 gen(Seed);
+        auto Random = [&] { return LPRKernelAccess::Convert<Search>(Graph.RandomSolution(NoColors, gen)); };
+
+        Search Solver(Graph.NoNodes, Graph.NoEdges, NoColors, Graph.Edges, Parameters, Seed);
+        Reference Ref(Graph, Parameters);
+        typename Search::WorkspaceType Work;
+        Work.Reserve(Graph.NoNodes, NoColors, Graph.NoNodes, Parameters.NoRandCandidates, Parameters.GapSamples);
+        try
+        {
+            int Rounds = gen() % 8;
+            for (int Round = 0; Round < Rounds; ++Round)
+            {
+                SolutionType S = Random();
+                LPRKernelAccess::UpdatePenaltyMatrix(Solver, S);
+                Ref.UpdatePenalties(S);
+                SolutionType Probe = Random();
+                Expect(LPRKernelAccess::AugmentedSumConstraintViolations(Solver, Probe) == Ref.Cost(Probe, true), "augmented cost after penalty update");
+            }
+
+            bool Augmented = gen() % 2 == 0;
+            SolutionType S = Random();
+            LPRKernelAccess::InitializePrecalcMatrixes(Solver, S, Work, Augmented);
+            int Cost = Augmented ? LPRKernelAccess::AugmentedSumConstraintViolations(Solver, S) : LPRKernelAccess::SumConstraintViolations(Solver, S);
+            Expect(Cost == Ref.Cost(S, Augmented), "initial cost");
+            Expect(LPRKernelAccess::SumConstraintViolations(Solver, S) == Ref.Cost(S, false), "initial plain cost");
+            CheckMatrices<Search>(Ref, S, Work, Augmented, NoColors);
+
+            for (int Move = 0; Move < MovesPerCase; ++Move)
+            {
+                int Node = gen() % Graph.NoNodes;
+                int NewColor = 1 + gen() % NoColors;
+                int Delta = Work.ColorChangeSum[Node][S[Node]] - Work.ColorChangeSum[Node][NewColor];
+                if (Augmented)
+                    Delta += Work.ColorChangeWeightSum[Node][S[Node]] - Work.ColorChangeWeightSum[Node][NewColor];
+
+                LPRKernelAccess::UpdatePrecalcMatrixes(Solver, S, { Node, NewColor }, Work, Augmented);
+                S[Node] = (typename Search::ColorType)NewColor;
+                Cost -= Delta;
+
+                Expect(Cost == Ref.Cost(S, Augmented), "cost after move " + std::to_string(Move));
+                CheckMatrices<Search>(Ref, S, Work, Augmented, NoColors);
+                LPRKernelAccess::VerifyIncrementalState(Solver, S, Cost, Work, Augmented);
+                CheckGapColors(Solver, Ref, S, Work, Augmented, gen() % Graph.NoNodes, NoColors);
+            }
+
+            SolutionType FirstParent = Random();
+            SolutionType SecondParent = Random();
+            SolutionType Child;
+            LPRKernelAccess::MixedPathRelinking(Solver, FirstParent, SecondParent, Child);
+            Expect(Child == Ref.Relink(FirstParent, SecondParent), "path relinking child");
+        }
+        catch (Mismatch& Failure)
+        {
+            Failure.What = std::string(Solver.Layout()) + ", " + Failure.What;
+            throw;
+        }
+    }
+
+    // Lowest free color for every node in order of decreasing degree, as UETT does for
+    // its span bound; the largest color used is a K for which the instance is solvable.
+    int GreedySpan(const SyntheticGraph& Graph)
+    {
+        std::vector<int> Degree(Graph.NoNodes, 0);
+        std::vector<int> Order(Graph.NoNodes);
+        for (int Node = 0; Node < Graph.NoNodes; ++Node)
+        {
+            Order[Node] = Node;
+            for (int Weight : Graph.Edges[Node])
+                Degree[Node] += 2 * Weight - (Weight > 0);
+        }
+        std::stable_sort(Order.begin(), Order.end(), [&](int First, int Second) { return Degree[First] > Degree[Second]; });
+
+        std::vector<int> Colors(Graph.NoNodes, 0);
+        std::vector<std::pair<int, int>> Windows;
+        int Span = 1;
+        for (int Node : Order)
+        {
+            Windows.clear();
+            for (int Neighbour = 0; Neighbour < Graph.NoNodes; ++Neighbour)
+            {
+                int Weight = Graph.Edges[Node][Neighbour];
+                if (Weight > 0 && Colors[Neighbour] > 0)
+                    Windows.push_back({ Colors[Neighbour] - Weight + 1, Colors[Neighbour] + Weight - 1 });
+            }
+            std::sort(Windows.begin(), Windows.end());
+            int Color = 1;
+            for (const auto& Window : Windows)
+            {
+                if (Window.first > Color)
+                    break;
+                Color = std::max(Color, Window.second + 1);
+            }
+            Colors[Node] = Color;
+            Span = std::max(Span, Color);
+        }
+        return Span;
+    }
+
+    enum class SolveMode { None, Split, Peel, Reorder };
+
+    void CheckReorder(const SyntheticGraph& Graph)
+    {
+        std::vector<int> Order = GraphReduction::ReverseCuthillMcKee(Graph.Edges);
+        std::vector<int> Sorted = Order;
+        std::sort(Sorted.begin(), Sorted.end());
+        for (int Node = 0; Node < Graph.NoNodes; ++Node)
+            Expect(Sorted[Node] == Node, "reverse Cuthill-McKee order is not a permutation");
+
+        GraphComponent Reordered = GraphReduction::Induce(Graph.Edges, Order);
+        Expect(Reordered.Nodes == Order && Reordered.NoEdges == Graph.NoEdges, "reordered component does not keep the order");
+        for (int First = 0; First < Graph.NoNodes; ++First)
+        {
+            for (int Second = 0; Second < Graph.NoNodes; ++Second)
+                Expect(Reordered.Edges[First][Second] == Graph.Edges[Order[First]][Order[Second]], "reordered edge does not map back");
+        }
+    }
+
+    // Isolated nodes, single edges and a few random components, numbered in random order
+    // so that every part maps back through scattered ids. With Hanging, chains and trees
+    // are attached to random nodes of the components.
+    SyntheticGraph SolveInstance(std::mt19937& gen, int MaxNodes, int MaxWeight, bool Hanging)
+    {
+        std::vector<std::pair<int, int>> EdgeList;
+        std::vector<int> Weights;
+        int NoNodes = 0;
+        auto AddEdge = [&](int First, int Second) {
+            EdgeList.push_back({ First, Second });
+            Weights.push_back(1 + gen() % MaxWeight);
+        };
+
+        NoNodes += gen() % 4;
+        for (int Pair = gen() % 4; Pair > 0; --Pair, NoNodes += 2)
+            AddEdge(NoNodes, NoNodes + 1);
+        int FirstCore = NoNodes;
+        for (int Component = 1 + gen() % 3; Component > 0; --Component)
+        {
+            int Size = 3 + gen() % std::max(1, MaxNodes / 2 - 2);
+            double Density = std::uniform_real_distribution<double>(0.2, 0.8)(gen);
+            // A spanning path keeps the component connected.
+            for (int Node = 1; Node < Size; ++Node)
+            {
+                AddEdge(NoNodes + Node - 1, NoNodes + Node);
+                for (int Other = 0; Other + 1 < Node; ++Other)
+                {
+                    if (std::uniform_real_distribution<double>(0, 1)(gen) < Density)
+                        AddEdge(NoNodes + Other, NoNodes + Node);
+                }
+            }
+            NoNodes += Size;
+        }
+
+        int NoCore = NoNodes - FirstCore;
+        for (int Branch = Hanging ? 1 + gen() % 4 : 0; Branch > 0; --Branch)
+        {
+            // A chain extends its last node, a tree node hangs off any earlier node of the branch.
+            bool Chain = gen() % 2 == 0;
+            int Root = FirstCore + gen() % NoCore;
+            int First = NoNodes;
+            for (int Size = 1 + gen() % 6; Size > 0; --Size, ++NoNodes)
+            {
+                int Parent = NoNodes == First ? Root : Chain ? NoNodes - 1 : First + gen() % (NoNodes - First);
+                AddEdge(Parent, NoNodes);
+            }
+        }
+
+        std::vector<int> Ids(NoNodes);
+        std::iota(Ids.begin(), Ids.end(), 0);
+        std::shuffle(Ids.begin(), Ids.end(), gen);
+        SyntheticGraph Graph;
+        Graph.NoNodes = NoNodes;
+        Graph.NoEdges = EdgeList.size();
+        Graph.Edges.assign(NoNodes, std::vector<int>(NoNodes, 0));
+        for (int Index = 0; Index < (int)EdgeList.size(); ++Index)
+        {
+            auto [First, Second] = EdgeList[Index];
+            Graph.Edges[Ids[First]][Ids[Second]] = Graph.Edges[Ids[Second]][Ids[First]] = Weights[Index];
+        }
+        return Graph;
+    }
+
+    bool RunSolveCase(unsigned Seed, int MaxNodes, SolveMode Mode)
+    {
+        std::mt19937 gen(Seed);
+        int MaxWeight = 1 + gen() % 5;
+        SyntheticGraph Graph = SolveInstance(gen, MaxNodes, MaxWeight, Mode != SolveMode::Split);
+        int NoColors = GreedySpan(Graph) + gen() % 3;
+
+        LPRParameters Parameters;
+        Parameters.PopulationSize = 4;
+        Parameters.SplitComponents = true;
+        Parameters.PeelLowDegree = Mode != SolveMode::Split;
+        Parameters.ReorderNodes = Mode == SolveMode::Reorder;
+        Parameters.TimeLimit = 10;
+
+        try
+        {
+            if (Parameters.ReorderNodes)
+                CheckReorder(Graph);
+            // A hanging leaf forbids at most 2 * MaxWeight - 1 colors, below K it must be peeled.
+            if (Parameters.PeelLowDegree && 2 * MaxWeight - 1 < NoColors)
+                Expect(!GraphReduction::PeelLowDegree(Graph.Edges, NoColors).empty(), "nothing peeled");
+            LPR Solver(Graph.NoNodes, Graph.NoEdges, NoColors, Graph.Edges, Parameters, Seed);
+            std::vector<int> Solution = Solver.Solve();
+            Expect(Solution.size() == (size_t)Graph.NoNodes, "no coloring at a K the greedy coloring reaches");
+            for (int Node = 0; Node < Graph.NoNodes; ++Node)
+            {
+                Expect(Solution[Node] >= 1 && Solution[Node] <= NoColors, "color out of range at node " + std::to_string(Node));
+                for (int Neighbour = 0; Neighbour < Node; ++Neighbour)
+                {
+                    int Weight = Graph.Edges[Node][Neighbour];
+                    Expect(std::abs(Solution[Node] - Solution[Neighbour]) >= Weight,
+                        "edge " + std::to_string(Neighbour) + "-" + std::to_string(Node) + " violated");
+                }
+            }
+        }
+        catch (const Mismatch& Failure)
+        {
+            std::cerr << "case seed " << Seed << " (n " << Graph.NoNodes << ", K " << NoColors << "): " << Failure.What << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    template <typename... Layouts>
+    bool RunCase(unsigned Seed, int MaxNodes)
+    {
+        std::mt19937 gen(Seed);
+        int NoNodes = 2 + gen() % (MaxNodes - 1);
+        double Density = std::uniform_real_distribution<double>(0.02, 0.7)(gen);
+        int MaxWeight = 1 + gen() % 8;
+        SyntheticGraph Graph(NoNodes, Density, MaxWeight, gen());
+        int NoColors = 2 + gen() % 60;
+
+        LPRParameters Parameters;
+        Parameters.MaxPenaltyWeight = 1 + gen() % 6;
+        Parameters.ScalingFactor = std::uniform_real_distribution<float>(0.1f, 0.9f)(gen);
+        Parameters.GapSamples = gen() % 3;
+
+        try
+        {
+            (RunLayout<Layouts>(Seed, Graph, NoColors, Parameters), ...);
+        }
+        catch (const Mismatch& Failure)
+        {
+            std::cerr << "case seed " << Seed << " (n " << NoNodes << ", K " << NoColors << "): " << Failure.What << "\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int NoCases = 200;
+    unsigned Seed = 1;
+    int MaxNodes = 40;
+    SolveMode Solve = SolveMode::None;
+    auto Usage = [&](std::ostream& Out) { Out << "usage: " << argv[0] << " [--cases N] [--seed S] [--max-nodes N] [--solve split|peel|reorder]\n"; };
+    for (int Index = 1; Index < argc; Index += 2)
+    {
+        std::string Option = argv[Index];
+        if (Option == "--help" || Option == "-h")
+        {
+            Usage(std::cout);
+            return 0;
+        }
+        bool Known = Option == "--cases" || Option == "--seed" || Option == "--max-nodes" || Option == "--solve";
+        if (!Known || Index + 1 >= argc)
+        {
+            std::cerr << (Known ? "missing value for " : "unknown option ") << Option << "\n";
+            Usage(std::cerr);
+            return 2;
+        }
+
+        std::string Value = argv[Index + 1];
+        try
+        {
+            if (Option == "--cases")
+                NoCases = std::stoi(Value);
+            else if (Option == "--seed")
+                Seed = (unsigned)std::stoul(Value);
+            else if (Option == "--max-nodes")
+                MaxNodes = std::max(2, std::stoi(Value));
+            else if (Value == "split")
+                Solve = SolveMode::Split;
+            else if (Value == "peel")
+                Solve = SolveMode::Peel;
+            else if (Value == "reorder")
+                Solve = SolveMode::Reorder;
+            else
+                throw std::invalid_argument(Value);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "invalid value for " << Option << ": " << Value << "\n";
+            Usage(std::cerr);
+            return 2;
+        }
+    }
+
+    for (int Case = 0; Case < NoCases; ++Case)
+    {
+        bool Passed = Solve != SolveMode::None ? RunSolveCase(Seed + Case, MaxNodes, Solve)
+            : RunCase<LPRSearch<uint8_t, int16_t>, LPRSearch<uint8_t, int32_t>, LPRSearch<uint16_t, int16_t>,
+                LPRSearch<uint16_t, int32_t>, LPRSearch<int32_t, int32_t>>(Seed + Case, MaxNodes);
+        if (!Passed)
+            return 1;
+    }
+    std::cout << NoCases << " cases passed\n";
+    return 0;
+}
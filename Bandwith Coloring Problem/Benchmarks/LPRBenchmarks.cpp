@@ -0,0 +1,271 @@
+#include <benchmark/benchmark.h>
+#include <set>
+#include <cmath>
+
+#include "LPRKernelAccess.h"
+#include "SyntheticGraph.h"
+#include "../GraphReduction.h"
+
+// Micro-benchmarks of the LPR kernels on random graphs.
+// Arguments: number of nodes, edge density in per mille, number of colors K.
+// Every kernel runs on the narrow (u8 colors, i16 sums) and the wide (i32) layout.
+
+namespace
+{
+    const int MaxWeight = 5;
+    const int PopulationSize = 20;
+
+    LPRParameters Parameters()
+    {
+        LPRParameters Result;
+        Result.PopulationSize = PopulationSize;
+        return Result;
+    }
+
+    using Narrow = LPRSearch<uint8_t, int16_t>;
+    using Wide = LPRSearch<int32_t, int32_t>;
+
+    template <typename Search>
+    struct Fixture
+    {
+        using SolutionType = typename Search::SolutionType;
+        using WorkspaceType = typename Search::WorkspaceType;
+
+        SyntheticGraph Graph;
+        Search Solver;
+        std::mt19937 gen;
+        int NoColors;
+
+        explicit Fixture(const benchmark::State& state)
+            : Graph((int)state.range(0), state.range(1) / 1000.0, MaxWeight, 12345),
+              Solver(Graph.NoNodes, Graph.NoEdges, (int)state.range(2), Graph.Edges, Parameters(), 4242),
+              gen(777),
+              NoColors((int)state.range(2))
+        {
+        }
+
+        SolutionType RandomSolution() { return LPRKernelAccess::Convert<Search>(Graph.RandomSolution(NoColors, gen)); }
+    };
+
+    void GraphArguments(benchmark::internal::Benchmark* b)
+    {
+        b->ArgNames({ "n", "density", "K" });
+        b->Args({ 100, 100, 20 });
+        b->Args({ 250, 100, 40 });
+        b->Args({ 500, 50, 60 });
+        b->Args({ 1000, 20, 100 });
+        b->Args({ 1000, 10, 250 });
+    }
+}
+
+template <typename Search>
+static void BM_SumConstraintViolations(benchmark::State& state)
+{
+    Fixture<Search> F(state);
+    auto Solution = F.RandomSolution();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(LPRKernelAccess::SumConstraintViolations(F.Solver, Solution));
+}
+BENCHMARK_TEMPLATE(BM_SumConstraintViolations, Narrow)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BM_SumConstraintViolations, Wide)->Apply(GraphArguments);
+
+template <typename Search>
+static void BM_InitializePrecalcMatrixes(benchmark::State& state)
+{
+    Fixture<Search> F(state);
+    auto Solution = F.RandomSolution();
+    typename Fixture<Search>::WorkspaceType Work;
+    bool IsAugmented = true;
+    for (auto _ : state)
+    {
+        LPRKernelAccess::InitializePrecalcMatrixes(F.Solver, Solution, Work, IsAugmented);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_InitializePrecalcMatrixes, Narrow)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BM_InitializePrecalcMatrixes, Wide)->Apply(GraphArguments);
+
+template <typename Search>
+static void BM_UpdatePrecalcMatrixes(benchmark::State& state)
+{
+    Fixture<Search> F(state);
+    auto Solution = F.RandomSolution();
+    typename Fixture<Search>::WorkspaceType Work;
+    bool IsAugmented = true;
+    LPRKernelAccess::InitializePrecalcMatrixes(F.Solver, Solution, Work, IsAugmented);
+
+    std::uniform_int_distribution<int> node(0, F.Graph.NoNodes - 1);
+    std::uniform_int_distribution<int> color(1, F.NoColors);
+    for (auto _ : state)
+    {
+        std::pair<int, int> Move = { node(F.gen), color(F.gen) };
+        LPRKernelAccess::UpdatePrecalcMatrixes(F.Solver, Solution, Move, Work, IsAugmented);
+        Solution[Move.first] = (typename Search::ColorType)Move.second;
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_UpdatePrecalcMatrixes, Narrow)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BM_UpdatePrecalcMatrixes, Wide)->Apply(GraphArguments);
+
+template <typename Search>
+static void TabuSearchIterations(benchmark::State& state, bool ExactNeighbourhood)
+{
+    // A whole tabu search with a short depth; the reported rate is tabu iterations/s.
+    Fixture<Search> F(state);
+    LPRKernelAccess::SetSearchDepth(F.Solver, 200, 200);
+    LPRKernelAccess::SetNeighbourhood(F.Solver, ExactNeighbourhood);
+    auto Start = F.RandomSolution();
+
+    int64_t Iterations = 0;
+    auto Solution = Start;
+    for (auto _ : state)
+    {
+        Solution = Start;
+        int64_t Before = LPRKernelAccess::TabuIterations(F.Solver);
+        LPRKernelAccess::TabuSearchImpr(F.Solver, Solution, false);
+        Iterations += LPRKernelAccess::TabuIterations(F.Solver) - Before;
+    }
+    state.counters["tabu_iterations"] = benchmark::Counter((double)Iterations, benchmark::Counter::kIsRate);
+    state.counters["ns_per_iteration"] = benchmark::Counter((double)Iterations, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template <typename Search>
+static void BM_TabuSearchIteration(benchmark::State& state)
+{
+    TabuSearchIterations<Search>(state, true);
+}
+BENCHMARK_TEMPLATE(BM_TabuSearchIteration, Narrow)->Apply(GraphArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TabuSearchIteration, Wide)->Apply(GraphArguments)->Unit(benchmark::kMillisecond);
+
+template <typename Search>
+static void BM_GapTabuSearchIteration(benchmark::State& state)
+{
+    TabuSearchIterations<Search>(state, false);
+}
+BENCHMARK_TEMPLATE(BM_GapTabuSearchIteration, Narrow)->Apply(GraphArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GapTabuSearchIteration, Wide)->Apply(GraphArguments)->Unit(benchmark::kMillisecond);
+
+template <typename Search>
+static void BM_MixedPathRelinking(benchmark::State& state)
+{
+    Fixture<Search> F(state);
+    auto FirstParent = F.RandomSolution();
+    auto SecondParent = F.RandomSolution();
+    typename Fixture<Search>::SolutionType Child;
+    for (auto _ : state)
+    {
+        LPRKernelAccess::MixedPathRelinking(F.Solver, FirstParent, SecondParent, Child);
+        benchmark::DoNotOptimize(Child.data());
+    }
+}
+BENCHMARK_TEMPLATE(BM_MixedPathRelinking, Narrow)->Apply(GraphArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MixedPathRelinking, Wide)->Apply(GraphArguments)->Unit(benchmark::kMillisecond);
+
+template <typename Search>
+static void BM_DistanceHamming(benchmark::State& state)
+{
+    Fixture<Search> F(state);
+    std::vector<typename Fixture<Search>::SolutionType> Population;
+    for (int Index = 0; Index < PopulationSize; ++Index)
+        Population.push_back(F.RandomSolution());
+    LPRKernelAccess::SetPopulation(F.Solver, Population);
+
+    auto Solution = F.RandomSolution();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(LPRKernelAccess::DistanceHamming(F.Solver, Solution));
+}
+BENCHMARK_TEMPLATE(BM_DistanceHamming, Narrow)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BM_DistanceHamming, Wide)->Apply(GraphArguments);
+
+template <typename Search>
+static void BM_UpdatePenaltyMatrix(benchmark::State& state)
+{
+    Fixture<Search> F(state);
+    auto Solution = F.RandomSolution();
+    for (auto _ : state)
+    {
+        LPRKernelAccess::UpdatePenaltyMatrix(F.Solver, Solution);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_UpdatePenaltyMatrix, Narrow)->Apply(GraphArguments);
+BENCHMARK_TEMPLATE(BM_UpdatePenaltyMatrix, Wide)->Apply(GraphArguments);
+
+using HeapSolution = std::vector<uint8_t>;
+using HeapPopulation = std::set<HeapSolution>;
+using PoolSolution = PooledSolution<uint8_t>;
+using PoolPopulation = std::set<PoolSolution, std::less<PoolSolution>, PoolAllocator<PoolSolution>>;
+
+template <typename Solution, typename Population>
+static void BM_PopulationChurn(benchmark::State& state)
+{
+    // The population update of Improvement_and_Updating on every thread at once: copy a
+    // child of n = 1000 nodes, insert it and drop the worst member. With std::allocator
+    // all threads contend for the global heap, the pool serves each from its own lists.
+    const int NoNodes = 1000;
+    std::mt19937 gen(1234 + state.thread_index());
+    Population Members;
+    Solution Child(NoNodes);
+    for (int Index = 0; Index < PopulationSize; ++Index)
+    {
+        for (auto& Color : Child)
+            Color = (uint8_t)gen();
+        Members.insert(Child);
+    }
+
+    for (auto _ : state)
+    {
+        Solution Candidate = *Members.begin();
+        Candidate[gen() % NoNodes] = (uint8_t)gen();
+        Candidate[gen() % NoNodes] = (uint8_t)gen();
+        if (Members.insert(std::move(Candidate)).second)
+            Members.erase(std::prev(Members.end()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_PopulationChurn, HeapSolution, HeapPopulation)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PopulationChurn, PoolSolution, PoolPopulation)->ThreadRange(1, 32)->UseRealTime();
+
+template <typename Search>
+static void BM_NodeOrder(benchmark::State& state)
+{
+    // The plain tabu search on a geometric graph, with ids in file order against reverse
+    // Cuthill-McKee order, both from the same start coloring. Only time is measured; a
+    // Google Benchmark built with libpfm adds cache misses with
+    // --benchmark_perf_counters=CACHE-MISSES. Arguments: n, average degree, ordered.
+    int NoNodes = (int)state.range(0);
+    double Radius = std::sqrt(state.range(1) / (3.14159265 * NoNodes));
+    SyntheticGraph Graph = SyntheticGraph::Geometric(NoNodes, Radius, MaxWeight, 12345);
+    const int NoColors = 60;
+    std::mt19937 gen(777);
+    std::vector<int> Start = Graph.RandomSolution(NoColors, gen);
+    if (state.range(2))
+    {
+        GraphComponent Reordered = GraphReduction::Induce(Graph.Edges, GraphReduction::ReverseCuthillMcKee(Graph.Edges));
+        Graph.Edges = std::move(Reordered.Edges);
+        std::vector<int> Permuted(NoNodes);
+        for (int Node = 0; Node < NoNodes; ++Node)
+            Permuted[Node] = Start[Reordered.Nodes[Node]];
+        Start = std::move(Permuted);
+    }
+
+    Search Solver(NoNodes, Graph.NoEdges, NoColors, Graph.Edges, Parameters(), 4242);
+    LPRKernelAccess::SetSearchDepth(Solver, 100, 100);
+    auto First = LPRKernelAccess::Convert<Search>(Start);
+    auto Solution = First;
+
+    int64_t Iterations = 0;
+    for (auto _ : state)
+    {
+        Solution = First;
+        int64_t Before = LPRKernelAccess::TabuIterations(Solver);
+        LPRKernelAccess::TabuSearchImpr(Solver, Solution, false);
+        Iterations += LPRKernelAccess::TabuIterations(Solver) - Before;
+    }
+    state.counters["tabu_iterations"] = benchmark::Counter((double)Iterations, benchmark::Counter::kIsRate);
+    state.counters["ns_per_iteration"] = benchmark::Counter((double)Iterations, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK_TEMPLATE(BM_NodeOrder, Narrow)->ArgNames({ "n", "degree", "ordered" })->ArgsProduct({ { 2000, 8000 }, { 30 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_NodeOrder, Wide)->ArgNames({ "n", "degree", "ordered" })->ArgsProduct({ { 2000, 8000 }, { 30 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../LPRSearch.h"
+
+// Thin forwarding layer over the private LPR kernels, shared by the benchmark
+// and verification executables. Keep the signatures in sync with LPRSearch.h.
+// Search is one of the LPRSearch<Color, Sum> layouts instantiated in LPR.cpp.
+struct LPRKernelAccess
+{
+    template <typename Search>
+    using SolutionType = typename Search::SolutionType;
+    template <typename Search>
+    using WorkspaceType = typename Search::WorkspaceType;
+
+    template <typename Search>
+    static SolutionType<Search> Convert(const std::vector<int>& Solution)
+    {
+        return SolutionType<Search>(Solution.begin(), Solution.end());
+    }
+
+    template <typename Search>
+    static void SetSearchDepth(Search& Solver, int Alpha, int Alpha0)
+    {
+        Solver.Alpha = Alpha;
+        Solver.Alpha0 = Alpha0;
+    }
+
+    template <typename Search>
+    static void SetNeighbourhood(Search& Solver, bool Exact)
+    {
+        Solver.ExactNeighbourhood = Exact;
+    }
+
+    template <typename Search>
+    static void SetPopulation(Search& Solver, const std::vector<SolutionType<Search>>& Solutions)
+    {
+        Solver.Population.clear();
+        for (const auto& Solution : Solutions)
+            Solver.Population.insert(Solution);
+    }
+
+    template <typename Search>
+    static int64_t TabuIterations(const Search& Solver) { return Solver.TabuIterations; }
+
+    template <typename Search>
+    static int SumConstraintViolations(Search& Solver, const SolutionType<Search>& Solution)
+    {
+        return Solver.SumConstraintViolations(Solution);
+    }
+
+    template <typename Search>
+    static int AugmentedSumConstraintViolations(Search& Solver, const SolutionType<Search>& Solution)
+    {
+        return Solver.AugmentedSumConstraintViolations(Solution);
+    }
+
+    template <typename Search>
+    static void InitializePrecalcMatrixes(Search& Solver, const SolutionType<Search>& Solution, WorkspaceType<Search>& Work, bool IsAugmented)
+    {
+        if (IsAugmented)
+            Solver.template InitializePrecalcMatrixes<Objective::Augmented>(Solution, Work);
+        else
+            Solver.template InitializePrecalcMatrixes<Objective::Plain>(Solution, Work);
+    }
+
+    template <typename Search>
+    static void UpdatePrecalcMatrixes(Search& Solver, const SolutionType<Search>& Solution, std::pair<int, int> Move, WorkspaceType<Search>& Work, bool IsAugmented)
+    {
+        if (IsAugmented)
+            Solver.template UpdatePrecalcMatrixes<Objective::Augmented>(Solution, Move, Work);
+        else
+            Solver.template UpdatePrecalcMatrixes<Objective::Plain>(Solution, Move, Work);
+    }
+
+    template <typename Search>
+    static void VerifyIncrementalState(Search& Solver, const SolutionType<Search>& Solution, int SolutionCost, WorkspaceType<Search>& Work, bool IsAugmented)
+    {
+        if (IsAugmented)
+            Solver.template VerifyIncrementalState<Objective::Augmented>(Solution, SolutionCost, Work);
+        else
+            Solver.template VerifyIncrementalState<Objective::Plain>(Solution, SolutionCost, Work);
+    }
+
+    template <typename Search>
+    static const std::vector<int>& CollectGapColors(Search& Solver, const SolutionType<Search>& Solution, int Node, WorkspaceType<Search>& Work)
+    {
+        Solver.CollectGapColors(Solution, Node, Work);
+        return Work.GapColors;
+    }
+
+    // The search routines below run on the solver's own workspace.
+    template <typename Search>
+    static void TabuSearchImpr(Search& Solver, SolutionType<Search>& Solution, bool IsAugmented)
+    {
+        if (IsAugmented)
+            Solver.template TabuSearchImpr<Objective::Augmented>(Solution, Solver.Workspace);
+        else
+            Solver.template TabuSearchImpr<Objective::Plain>(Solution, Solver.Workspace);
+    }
+
+    template <typename Search>
+    static void MixedPathRelinking(Search& Solver, const SolutionType<Search>& FirstParent, const SolutionType<Search>& SecondParent, SolutionType<Search>& Child)
+    {
+        Solver.MixedPathRelinking(FirstParent, SecondParent, Solver.Workspace, Child);
+    }
+
+    template <typename Search>
+    static int DistanceHamming(Search& Solver, const SolutionType<Search>& Solution)
+    {
+        return Solver.DistanceHamming(Solution);
+    }
+
+    template <typename Search>
+    static void UpdatePenaltyMatrix(Search& Solver, const SolutionType<Search>& Solution)
+    {
+        Solver.UpdatePenaltyMatrix(Solution);
+    }
+};
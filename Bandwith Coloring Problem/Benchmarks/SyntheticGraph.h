@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <random>
+
+// Random bandwidth coloring instance: every pair of nodes is an edge with
+// probability Density, with a weight drawn from [1, MaxWeight].
+// Geometric builds a GEOM-like instance instead, see below.
+struct SyntheticGraph
+{
+    int NoNodes = 0;
+    int NoEdges = 0;
+    std::vector<std::vector<int>> Edges;
+
+    SyntheticGraph() = default;
+
+    SyntheticGraph(int NoNodes, double Density, int MaxWeight, unsigned Seed)
+        : NoNodes(NoNodes), Edges(NoNodes, std::vector<int>(NoNodes, 0))
+    {
+        std::mt19937 gen(Seed);
+        std::uniform_real_distribution<double> coin(0, 1);
+        std::uniform_int_distribution<int> weight(1, MaxWeight);
+        for (int v1 = 0; v1 < NoNodes; ++v1)
+        {
+            for (int v2 = 0; v2 < v1; ++v2)
+            {
+                if (coin(gen) < Density)
+                {
+                    Edges[v1][v2] = Edges[v2][v1] = weight(gen);
+                    ++NoEdges;
+                }
+            }
+        }
+    }
+
+    // Random points in the unit square, joined when closer than Radius. Ids are in random
+    // order, as they come from the generator files, so neighbours are far apart in memory.
+    static SyntheticGraph Geometric(int NoNodes, double Radius, int MaxWeight, unsigned Seed)
+    {
+        std::mt19937 gen(Seed);
+        std::uniform_real_distribution<double> coordinate(0, 1);
+        std::uniform_int_distribution<int> weight(1, MaxWeight);
+        std::vector<std::pair<double, double>> Points(NoNodes);
+        for (auto& Point : Points)
+            Point = { coordinate(gen), coordinate(gen) };
+
+        SyntheticGraph Graph;
+        Graph.NoNodes = NoNodes;
+        Graph.Edges.assign(NoNodes, std::vector<int>(NoNodes, 0));
+        for (int v1 = 0; v1 < NoNodes; ++v1)
+        {
+            for (int v2 = 0; v2 < v1; ++v2)
+            {
+                double dx = Points[v1].first - Points[v2].first;
+                double dy = Points[v1].second - Points[v2].second;
+                if (dx * dx + dy * dy < Radius * Radius)
+                {
+                    Graph.Edges[v1][v2] = Graph.Edges[v2][v1] = weight(gen);
+                    ++Graph.NoEdges;
+                }
+            }
+        }
+        return Graph;
+    }
+
+    std::vector<int> RandomSolution(int NoColors, std::mt19937& gen) const
+    {
+        std::uniform_int_distribution<int> color(1, NoColors);
+        std::vector<int> Solution(NoNodes);
+        for (auto& Color : Solution)
+            Color = color(gen);
+        return Solution;
+    }
+};
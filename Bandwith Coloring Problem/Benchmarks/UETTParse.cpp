@@ -0,0 +1,176 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+#include "../SolverBenchmark.h"
+#include "../UETTReader.h"
+
+// Peak memory and time of loading a UETT instance, once with the streaming UETTReader
+// and once the way UETT used to: the whole document as an nlohmann::json DOM walked
+// into string maps. The peak is the high-water mark above the resident set before each load.
+// Usage: UETTParse <instance.json>
+//        UETTParse --students <count> [--seed n]   (synthetic instance in the temp directory)
+
+namespace
+{
+    const int NoMandatory = 10;
+    const int NoPacks = 40;
+    const int PackSize = 4;
+    const int PacksPerStudent = 5;
+
+    struct Measurement
+    {
+        double Seconds = 0;
+        int64_t PeakKb = 0;
+        size_t Exams = 0;
+        size_t Students = 0;
+        size_t Enrolments = 0;
+    };
+
+    std::string ExamName(int Exam)
+    {
+        return "\"e" + std::to_string(Exam) + "\"";
+    }
+
+    void WriteSynthetic(const std::string& Path, int NoStudents, unsigned Seed)
+    {
+        const char* Names[] = { "easy", "medium", "hard" };
+        std::mt19937 gen(Seed);
+        std::ofstream Fout(Path);
+
+        Fout << "{\n\"mandatory_exams\": {";
+        for (int Exam = 0; Exam < NoMandatory; ++Exam)
+            Fout << (Exam ? "," : "") << "\n\"" << Exam << "\": [" << ExamName(Exam) << ", \"" << Names[gen() % 3] << "\"]";
+        Fout << "\n},\n\"optional_packs\": {";
+        for (int Pack = 0; Pack < NoPacks; ++Pack)
+        {
+            Fout << (Pack ? "," : "") << "\n\"" << Pack << "\": [[";
+            for (int Index = 0; Index < PackSize; ++Index)
+                Fout << (Index ? ", " : "") << ExamName(NoMandatory + Pack * PackSize + Index);
+            Fout << "], \"" << Names[gen() % 3] << "\"]";
+        }
+        Fout << "\n},\n\"students\": {";
+        for (int Student = 0; Student < NoStudents; ++Student)
+        {
+            Fout << (Student ? "," : "") << "\n\"" << Student << "\": [";
+            for (int Exam = 0; Exam < NoMandatory; ++Exam)
+                Fout << (Exam ? ", " : "") << ExamName(Exam);
+            for (int Pick = 0; Pick < PacksPerStudent; ++Pick)
+                Fout << ", " << ExamName(NoMandatory + (int)(gen() % (NoPacks * PackSize)));
+            Fout << "]";
+        }
+        Fout << "\n}\n}\n";
+    }
+
+    template <typename Load>
+    Measurement Measure(Load&& Body)
+    {
+        SolverBenchmark::ResetPeakRss();
+        int64_t Before = SolverBenchmark::PeakRssKb();
+        auto Start = std::chrono::steady_clock::now();
+        Measurement Result = Body();
+        Result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        Result.PeakKb = SolverBenchmark::PeakRssKb() - Before;
+        return Result;
+    }
+
+    Measurement Streaming(const std::string& Path)
+    {
+        return Measure([&] {
+            std::ifstream Fin(Path);
+            UETTReader Reader;
+            Reader.Read(Fin);
+            Measurement Result;
+            Result.Exams = Reader.Exams.Size();
+            Result.Students = Reader.Students.Size();
+            Result.Enrolments = Reader.EnrolmentExams.size();
+            return Result;
+        });
+    }
+
+    Measurement Dom(const std::string& Path)
+    {
+        return Measure([&] {
+            std::ifstream Fin(Path);
+            nlohmann::json j;
+            Fin >> j;
+
+            std::map<std::string, std::string> Difficulties;
+            std::map<std::string, std::set<std::string>> ExamToStudents;
+            for (auto& [key, value] : j["mandatory_exams"].items())
+                Difficulties[value[0]] = value[1];
+            for (auto& [key, value] : j["optional_packs"].items())
+                for (const auto& exam : value[0])
+                    Difficulties[exam] = value[1];
+            Measurement Result;
+            for (auto& [key, value] : j["students"].items())
+            {
+                for (const auto& exam : value)
+                    ExamToStudents[exam].insert(key);
+                Result.Enrolments += value.size();
+                ++Result.Students;
+            }
+            Result.Exams = Difficulties.size();
+            return Result;
+        });
+    }
+
+    void Print(const char* Name, const Measurement& Result)
+    {
+        std::cout << Name << ": " << Result.Seconds << " s, peak +" << Result.PeakKb << " kB, exams=" << Result.Exams
+            << " students=" << Result.Students << " enrolments=" << Result.Enrolments << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string Path;
+    int NoStudents = 0;
+    unsigned Seed = 1;
+    if (argc == 2 && std::string(argv[1]).rfind("--", 0) != 0)
+        Path = argv[1];
+    else
+    {
+        for (int Index = 1; Index < argc; Index += 2)
+        {
+            std::string Option = argv[Index];
+            if (Index + 1 >= argc || (Option != "--students" && Option != "--seed"))
+            {
+                NoStudents = 0;
+                break;
+            }
+            if (Option == "--students")
+                NoStudents = std::stoi(argv[Index + 1]);
+            else
+                Seed = (unsigned)std::stoul(argv[Index + 1]);
+        }
+        if (NoStudents <= 0)
+        {
+            std::cerr << "usage: " << argv[0] << " <instance.json> | --students <count> [--seed n]\n";
+            return 2;
+        }
+        Path = (std::filesystem::temp_directory_path() / "bcp_uett_synthetic.json").string();
+        WriteSynthetic(Path, NoStudents, Seed);
+        std::cout << "synthetic instance: " << Path << " (" << std::filesystem::file_size(Path) / 1024 << " kB)\n";
+    }
+
+    try
+    {
+        Print("streaming", Streaming(Path));
+        Print("dom", Dom(Path));
+    }
+    catch (const std::exception& Ex)
+    {
+        std::cerr << Ex.what() << "\n";
+        return 1;
+    }
+
+    if (NoStudents > 0)
+        std::filesystem::remove(Path);
+    return 0;
+}
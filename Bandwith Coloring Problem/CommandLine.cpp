@@ -0,0 +1,174 @@
+#include "CommandLine.h"
+#include "BatchDriver.h"
+
+#include <map>
+#include <functional>
+#include <stdexcept>
+#include <filesystem>
+
+namespace
+{
+    int ToInt(const std::string& Option, const std::string& Value, int Min)
+    {
+        size_t End = 0;
+        int Result = 0;
+        try { Result = std::stoi(Value, &End); }
+        catch (const std::exception&) { End = 0; }
+        if (End != Value.size() || End == 0 || Result < Min)
+            throw std::invalid_argument(Option + " expects an integer >= " + std::to_string(Min) + ", got '" + Value + "'");
+        return Result;
+    }
+
+    double ToDouble(const std::string& Option, const std::string& Value)
+    {
+        size_t End = 0;
+        double Result = 0;
+        try { Result = std::stod(Value, &End); }
+        catch (const std::exception&) { End = 0; }
+        if (End != Value.size() || End == 0 || Result < 0)
+            throw std::invalid_argument(Option + " expects a non-negative number, got '" + Value + "'");
+        return Result;
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+CommandLine CommandLine::Parse(int argc, char** argv)
+{
+    CommandLine Result;
+    LPRParameters& Parameters = Result.Options.Parameters;
+    bool ReplicasGiven = false;
+
+    std::map<std::string, std::function<void(const std::string&)>> Valued = {
+        { "--problem", [&](const std::string& V) { Result.Problem = V; } },
+        { "--output", [&](const std::string& V) { Result.OutputPath = V; } },
+        { "--replicas", [&](const std::string& V) { Result.Options.Replicas = ToInt("--replicas", V, 1); ReplicasGiven = true; } },
+        { "--seed", [&](const std::string& V) { Result.Options.Seed = (unsigned)ToInt("--seed", V, 0); } },
+        { "--threads", [&](const std::string& V) { Result.Options.NoThreads = ToInt("--threads", V, 0); } },
+        { "--time-limit", [&](const std::string& V) { Parameters.TimeLimit = ToDouble("--time-limit", V); } },
+        { "--population", [&](const std::string& V) { Parameters.PopulationSize = ToInt("--population", V, 2); } },
+        { "--alpha", [&](const std::string& V) { Parameters.Alpha = ToInt("--alpha", V, 1); } },
+        { "--alpha0", [&](const std::string& V) { Parameters.Alpha0 = ToInt("--alpha0", V, 1); } },
+        { "--tmax", [&](const std::string& V) { Parameters.Tmax = ToInt("--tmax", V, 1); } },
+        { "--max-penalty", [&](const std::string& V) { Parameters.MaxPenaltyWeight = ToInt("--max-penalty", V, 1); } },
+        { "--scaling", [&](const std::string& V) { Parameters.ScalingFactor = (float)ToDouble("--scaling", V); } },
+        { "--candidates", [&](const std::string& V) { Parameters.NoRandCandidates = ToInt("--candidates", V, 1); } },
+        { "--restarts", [&](const std::string& V) { Parameters.MaxRestarts = ToInt("--restarts", V, 1); } },
+        { "--neighbourhood", [&](const std::string& V) {
+            if (V != "exact" && V != "gap")
+                throw std::invalid_argument("--neighbourhood must be exact or gap, got '" + V + "'");
+            Parameters.ExactNeighbourhood = V == "exact"; } },
+        { "--gap-samples", [&](const std::string& V) { Parameters.GapSamples = ToInt("--gap-samples", V, 0); } },
+        { "--trace", [&](const std::string& V) { Result.Export.TraceCapacity = ToInt("--trace", V, 0); } },
+        { "--trace-stride", [&](const std::string& V) { Result.Export.TraceStride = ToInt("--trace-stride", V, 1); } },
+        { "--python", [&](const std::string& V) { Result.Python = V; } },
+    };
+    std::map<std::string, std::function<void()>> Flags = {
+        { "--help", [&] { Result.Help = true; } },
+        { "--trace-binary", [&] { Result.Export.TraceBinary = true; } },
+        { "--dot", [&] { Result.Export.Dot = true; } },
+        { "--json", [&] { Result.Export.Json = true; } },
+        { "--no-svg", [&] { Result.Export.Svg = false; } },
+        { "--no-render", [&] { Result.Render = false; } },
+        { "--no-split", [&] { Parameters.SplitComponents = false; } },
+        { "--no-peel", [&] { Parameters.PeelLowDegree = false; } },
+        { "--reorder", [&] { Parameters.ReorderNodes = true; } },
+    };
+
+    for (int Index = 1; Index < argc; ++Index)
+    {
+        std::string Argument = argv[Index];
+        if (Argument == "-h")
+            Argument = "--help";
+
+        if (Flags.count(Argument))
+            Flags[Argument]();
+        else if (Valued.count(Argument))
+        {
+            if (Index + 1 >= argc)
+                throw std::invalid_argument(Argument + " expects a value");
+            Valued[Argument](argv[++Index]);
+        }
+        else if (Argument.rfind("--", 0) == 0)
+            throw std::invalid_argument("unknown option " + Argument);
+        else
+            Result.Inputs.push_back(Argument);
+    }
+
+    if (Result.Problem != "bcp" && Result.Problem != "uett")
+        throw std::invalid_argument("--problem must be bcp or uett, got '" + Result.Problem + "'");
+    Parameters.Validate();
+    if (Result.Problem == "uett" && !ReplicasGiven)
+        Result.Options.Replicas = 1;
+    if (Result.Inputs.empty())
+    {
+        std::filesystem::path Instances("Instances");
+        if (Result.Problem == "bcp")
+            Result.Inputs.push_back((Instances / "BCP_Instances").string());
+        else
+            Result.Inputs.push_back((Instances / "UETT_Instances" / "generated_json").string());
+    }
+    return Result;
+}
+//------------------------------------------------------------------------------------------------
+
+std::string CommandLine::Usage(const std::string& Program)
+{
+    return "usage: " + Program + " [options] [inputs...]\n"
+        "Inputs are instance files or directories (default: Instances/BCP_Instances).\n"
+        "  --problem bcp|uett     problem type (default bcp)\n"
+        "  --output DIR           bcp output directory (default: Output next to the first input)\n"
+        "  --replicas N           LPR runs per instance (default 20 for bcp, 1 for uett)\n"
+        "  --seed N               replica r uses seed N + r (default: random)\n"
+        "  --threads N            solver threads, 0 = hardware concurrency\n"
+        "  --time-limit S         seconds per LPR run, 0 = no limit\n"
+        "  --population N         population size (20)\n"
+        "  --alpha N              tabu depth, plain objective (10000)\n"
+        "  --alpha0 N             tabu depth, augmented objective (2000)\n"
+        "  --tmax N               tabu tenure scale (50)\n"
+        "  --max-penalty N        penalty weight that triggers rescaling (30)\n"
+        "  --scaling F            penalty rescaling factor in [0, 1) (0.4)\n"
+        "  --candidates N         tied candidates kept per tabu step (100)\n"
+        "  --restarts N           population restarts (2)\n"
+        "  --neighbourhood M      exact: try every color, gap: only window edges (exact)\n"
+        "  --gap-samples N        random colors added to the gap neighbourhood (4)\n"
+        "  --no-split             search the whole graph instead of each connected component\n"
+        "  --no-peel              keep nodes that can be colored last in the search\n"
+        "  --reorder              renumber the nodes of every search in reverse Cuthill-McKee order\n"
+        "  --trace N              keep N convergence trace entries per replica\n"
+        "  --trace-stride N       trace every N-th tabu iteration (16)\n"
+        "  --trace-binary         write traces as .trace.bin instead of csv\n"
+        "  --dot, --json          also export the graph as dot / json\n"
+        "  --no-svg               skip the native svg export\n"
+        "  --no-render            do not run the python renderers\n"
+        "  --python PATH          python interpreter for the renderers (python)\n";
+}
+//------------------------------------------------------------------------------------------------
+
+std::vector<std::string> CommandLine::InputFiles(const std::string& Extension) const
+{
+    std::vector<std::string> Files;
+    for (const auto& Input : Inputs)
+    {
+        if (std::filesystem::is_directory(Input))
+        {
+            for (const auto& FileName : BatchDriver::ListInstances(Input, Extension))
+                Files.push_back(FileName);
+        }
+        else if (std::filesystem::exists(Input))
+            Files.push_back(Input);
+        else
+            throw std::invalid_argument("input " + Input + " does not exist");
+    }
+    return Files;
+}
+//------------------------------------------------------------------------------------------------
+
+std::string CommandLine::DefaultOutputPath() const
+{
+    if (!OutputPath.empty())
+        return OutputPath;
+    std::filesystem::path First(Inputs.front());
+    std::filesystem::path Directory = std::filesystem::is_directory(First) ? First : First.parent_path();
+    return (Directory / "Output").string();
+}
+//------------------------------------------------------------------------------------------------
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Solver.h"
+#include "GraphExport.h"
+
+// Options of the bcp executable. Parse throws std::invalid_argument on a malformed
+// command line; the caller prints Usage().
+struct CommandLine
+{
+    std::string Problem = "bcp";
+    std::vector<std::string> Inputs;
+    std::string OutputPath;
+    RunOptions Options;
+    ExportOptions Export;
+    bool Render = true;
+    std::string Python = "python";
+    bool Help = false;
+
+    static CommandLine Parse(int argc, char** argv);
+    static std::string Usage(const std::string& Program);
+
+    // Every input file, with directories expanded to their files with Extension.
+    std::vector<std::string> InputFiles(const std::string& Extension) const;
+    // The Output directory next to the first input unless --output was given.
+    std::string DefaultOutputPath() const;
+};
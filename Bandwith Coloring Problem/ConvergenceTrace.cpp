@@ -0,0 +1,64 @@
+#include "ConvergenceTrace.h"
+#include "GraphExport.h"
+
+#include <algorithm>
+#include <fstream>
+
+ConvergenceTrace::ConvergenceTrace(size_t Capacity, int64_t Stride)
+    : Ring(std::max<size_t>(1, Capacity)), Stride(std::max<int64_t>(1, Stride)), Start(std::chrono::steady_clock::now())
+{
+}
+//------------------------------------------------------------------------------------------------
+
+std::vector<TraceEntry> ConvergenceTrace::Entries() const
+{
+    std::vector<TraceEntry> Ordered;
+    Ordered.reserve(Count);
+    size_t First = (Next + Ring.size() - Count) % Ring.size();
+    for (size_t Index = 0; Index < Count; ++Index)
+        Ordered.push_back(Ring[(First + Index) % Ring.size()]);
+    return Ordered;
+}
+//------------------------------------------------------------------------------------------------
+
+void ConvergenceTrace::WriteCsv(const std::string& Path) const
+{
+    static const char* PhaseNames[] = { "plain", "augmented", "relinking" };
+
+    BufferedWriter Fout(Path);
+    Fout << "seconds,iteration,cost,best_cost,augmented_cost,phase\n";
+    char Seconds[32];
+    for (const auto& Entry : Entries())
+    {
+        int Length = std::snprintf(Seconds, sizeof(Seconds), "%.6f", Entry.Seconds);
+        Fout << std::string_view(Seconds, Length) << ',' << std::to_string(Entry.Iteration) << ',' << Entry.Cost << ','
+            << Entry.BestCost << ',' << Entry.AugmentedCost << ',' << PhaseNames[(int)Entry.Phase] << '\n';
+    }
+    Fout.Close();
+}
+//------------------------------------------------------------------------------------------------
+
+void ConvergenceTrace::WriteBinary(const std::string& Path) const
+{
+    // "LPRT", entry size and entry count, followed by the entries in time order. The fields
+    // are written one by one in native byte order, so no struct padding reaches the file.
+    const uint32_t EntrySize = sizeof(double) + sizeof(int64_t) + 3 * sizeof(int32_t) + sizeof(TracePhase);
+    std::ofstream Fout(Path, std::ios::binary);
+    std::vector<TraceEntry> Ordered = Entries();
+    uint64_t NoEntries = Ordered.size();
+    auto Write = [&](const auto& Value) { Fout.write(reinterpret_cast<const char*>(&Value), sizeof(Value)); };
+
+    Fout.write("LPRT", 4);
+    Write(EntrySize);
+    Write(NoEntries);
+    for (const auto& Entry : Ordered)
+    {
+        Write(Entry.Seconds);
+        Write(Entry.Iteration);
+        Write(Entry.Cost);
+        Write(Entry.BestCost);
+        Write(Entry.AugmentedCost);
+        Write(Entry.Phase);
+    }
+}
+//------------------------------------------------------------------------------------------------
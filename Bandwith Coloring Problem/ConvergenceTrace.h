@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+enum class TracePhase : uint8_t
+{
+    Plain = 0,
+    Augmented = 1,
+    Relinking = 2
+};
+
+struct TraceEntry
+{
+    double Seconds;
+    int64_t Iteration;
+    int32_t Cost;
+    int32_t BestCost;
+    int32_t AugmentedCost;
+    TracePhase Phase;
+};
+
+// Fixed-size ring buffer of search progress for one LPR run. Every Stride-th
+// iteration is kept, plus every iteration that improves the best cost, so the
+// tail of a long run is always available for time-to-target plots.
+class ConvergenceTrace
+{
+    std::vector<TraceEntry> Ring;
+    size_t Next = 0;
+    size_t Count = 0;
+    int64_t Stride;
+    std::chrono::steady_clock::time_point Start;
+public:
+    explicit ConvergenceTrace(size_t Capacity = 1 << 14, int64_t Stride = 16);
+
+    void Record(int64_t Iteration, int Cost, int BestCost, int AugmentedCost, TracePhase Phase, bool Improved)
+    {
+        if (!Improved && Iteration % Stride != 0)
+            return;
+
+        std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+        Ring[Next] = { Elapsed.count(), Iteration, Cost, BestCost, AugmentedCost, Phase };
+        Next = (Next + 1) % Ring.size();
+        Count = std::min(Count + 1, Ring.size());
+    }
+
+    std::vector<TraceEntry> Entries() const;
+    void WriteCsv(const std::string& Path) const;
+    void WriteBinary(const std::string& Path) const;
+};
@@ -0,0 +1,302 @@
+#include "GraphExport.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <filesystem>
+
+BufferedWriter::BufferedWriter(const std::string& Path, size_t Capacity)
+    : Path(Path), Buffer(Capacity)
+{
+    File = std::fopen(Path.c_str(), "wb");
+    if (File == nullptr)
+        throw std::runtime_error("Could not open " + Path);
+}
+//------------------------------------------------------------------------------------------------
+
+BufferedWriter::~BufferedWriter()
+{
+    if (File == nullptr)
+        return;
+    if (Used > 0)
+        std::fwrite(Buffer.data(), 1, Used, File);
+    std::fclose(File);
+}
+//------------------------------------------------------------------------------------------------
+
+BufferedWriter& BufferedWriter::operator<<(std::string_view Text)
+{
+    if (Used + Text.size() > Buffer.size())
+    {
+        Flush();
+        if (Text.size() > Buffer.size())
+        {
+            if (std::fwrite(Text.data(), 1, Text.size(), File) != Text.size())
+                throw std::runtime_error("Could not write " + Path);
+            return *this;
+        }
+    }
+
+    std::memcpy(Buffer.data() + Used, Text.data(), Text.size());
+    Used += Text.size();
+    return *this;
+}
+//------------------------------------------------------------------------------------------------
+
+BufferedWriter& BufferedWriter::operator<<(char Symbol)
+{
+    if (Used == Buffer.size())
+        Flush();
+
+    Buffer[Used++] = Symbol;
+    return *this;
+}
+//------------------------------------------------------------------------------------------------
+
+BufferedWriter& BufferedWriter::operator<<(int Value)
+{
+    char Digits[16];
+    auto Result = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+    return *this << std::string_view(Digits, Result.ptr - Digits);
+}
+//------------------------------------------------------------------------------------------------
+
+BufferedWriter& BufferedWriter::operator<<(double Value)
+{
+    char Digits[32];
+    int Length = std::snprintf(Digits, sizeof(Digits), "%.2f", Value);
+    return *this << std::string_view(Digits, Length);
+}
+//------------------------------------------------------------------------------------------------
+
+void BufferedWriter::Flush()
+{
+    size_t Written = Used > 0 ? std::fwrite(Buffer.data(), 1, Used, File) : 0;
+    bool Complete = Written == Used;
+    Used = 0;
+    if (Complete == false)
+        throw std::runtime_error("Could not write " + Path);
+}
+//------------------------------------------------------------------------------------------------
+
+void BufferedWriter::Close()
+{
+    Flush();
+    int Result = std::fclose(File);
+    File = nullptr;
+    if (Result != 0)
+        throw std::runtime_error("Could not write " + Path);
+}
+//------------------------------------------------------------------------------------------------
+
+RenderQueue::RenderQueue(std::string Python, int BatchSize)
+    : Python(Python), BatchSize(std::max(1, BatchSize))
+{
+    Worker = std::thread(&RenderQueue::WorkerLoop, this);
+}
+//------------------------------------------------------------------------------------------------
+
+RenderQueue::~RenderQueue()
+{
+    {
+        std::lock_guard<std::mutex> Guard(Lock);
+        Stopping = true;
+    }
+    Changed.notify_all();
+    Worker.join();
+}
+//------------------------------------------------------------------------------------------------
+
+void RenderQueue::Enqueue(const std::string& Script, const std::string& InputPath)
+{
+    {
+        std::lock_guard<std::mutex> Guard(Lock);
+        Pending.push_back({ Script, InputPath });
+    }
+    Changed.notify_all();
+}
+//------------------------------------------------------------------------------------------------
+
+void RenderQueue::Flush()
+{
+    std::unique_lock<std::mutex> Guard(Lock);
+    Changed.wait(Guard, [&] { return Pending.empty() && !Busy; });
+}
+//------------------------------------------------------------------------------------------------
+
+void RenderQueue::WorkerLoop()
+{
+    std::unique_lock<std::mutex> Guard(Lock);
+    while (true)
+    {
+        Changed.wait(Guard, [&] { return Stopping || !Pending.empty(); });
+        if (Pending.empty())
+            return;
+
+        std::string Script = Pending.front().first;
+        std::vector<std::string> Inputs;
+        for (auto It = Pending.begin(); It != Pending.end() && (int)Inputs.size() < BatchSize; )
+        {
+            if (It->first == Script)
+            {
+                Inputs.push_back(It->second);
+                It = Pending.erase(It);
+            }
+            else ++It;
+        }
+        Busy = true;
+        Guard.unlock();
+
+        std::string Command = Python + " \"" + Script + "\"";
+        for (const auto& Input : Inputs)
+            Command += " \"" + Input + "\"";
+
+        int result = system(Command.c_str());
+        if (result == 0)
+        {
+            for (const auto& Input : Inputs)
+                std::filesystem::remove(Input);
+        }
+
+        Guard.lock();
+        Busy = false;
+        Changed.notify_all();
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+void GraphExport::Export(const std::string& BasePath, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors, const ExportOptions& Options)
+{
+    if (Options.Dot)
+        WriteDot(BasePath + ".dot", NoNodes, Graph, Colors);
+    if (Options.Svg)
+        WriteSvg(BasePath + ".svg", NoNodes, Graph, Colors);
+    if (Options.Json)
+        WriteJson(BasePath + ".json", NoNodes, Graph, Colors);
+
+    if (Options.Renderer != nullptr)
+    {
+        WritePythonInput(BasePath + ".tmp", NoNodes, Graph, Colors);
+        Options.Renderer->Enqueue("Scripts/generate_graph.py", BasePath + ".tmp");
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+void GraphExport::WriteDot(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors)
+{
+    BufferedWriter Fout(Path);
+    Fout << "graph G {\n";
+    for (int Node = 0; Node < NoNodes; ++Node)
+        Fout << "  " << Node << " [label=\"" << Colors[Node] << "\"];\n";
+
+    for (int v1 = 0; v1 < NoNodes; ++v1)
+        for (int v2 = 0; v2 < v1; ++v2)
+            if (Graph[v1][v2] > 0)
+                Fout << "  " << v1 << " -- " << v2 << " [label=\"" << Graph[v1][v2] << "\"];\n";
+    Fout << "}\n";
+    Fout.Close();
+}
+//------------------------------------------------------------------------------------------------
+
+void GraphExport::WriteSvg(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors)
+{
+    // Nodes sit on a circle, the fill hue is derived from the assigned color.
+    const double Pi = 3.14159265358979323846;
+    double Radius = std::max(150.0, NoNodes * 12.0);
+    double Size = 2 * Radius + 80;
+    std::vector<double> X(NoNodes), Y(NoNodes);
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        X[Node] = Size / 2 + Radius * std::cos(2 * Pi * Node / std::max(1, NoNodes));
+        Y[Node] = Size / 2 + Radius * std::sin(2 * Pi * Node / std::max(1, NoNodes));
+    }
+
+    BufferedWriter Fout(Path);
+    Fout << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << Size << "\" height=\"" << Size << "\" font-family=\"sans-serif\" font-size=\"11\">\n";
+    Fout << "<g stroke=\"#999\">\n";
+    for (int v1 = 0; v1 < NoNodes; ++v1)
+        for (int v2 = 0; v2 < v1; ++v2)
+            if (Graph[v1][v2] > 0)
+                Fout << "<line x1=\"" << X[v1] << "\" y1=\"" << Y[v1] << "\" x2=\"" << X[v2] << "\" y2=\"" << Y[v2] << "\"/>\n";
+    Fout << "</g>\n<g text-anchor=\"middle\" fill=\"#555\">\n";
+    for (int v1 = 0; v1 < NoNodes; ++v1)
+        for (int v2 = 0; v2 < v1; ++v2)
+            if (Graph[v1][v2] > 0)
+                Fout << "<text x=\"" << (X[v1] + X[v2]) / 2 << "\" y=\"" << (Y[v1] + Y[v2]) / 2 << "\">" << Graph[v1][v2] << "</text>\n";
+    Fout << "</g>\n<g text-anchor=\"middle\" dominant-baseline=\"central\">\n";
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        Fout << "<circle cx=\"" << X[Node] << "\" cy=\"" << Y[Node] << "\" r=\"12\" fill=\"hsl(" << (Colors[Node] * 37) % 360 << ",70%,70%)\"/>";
+        Fout << "<text x=\"" << X[Node] << "\" y=\"" << Y[Node] << "\">" << Colors[Node] << "</text>\n";
+    }
+    Fout << "</g>\n</svg>\n";
+    Fout.Close();
+}
+//------------------------------------------------------------------------------------------------
+
+void GraphExport::WriteJson(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors)
+{
+    BufferedWriter Fout(Path);
+    Fout << "{\"nodes\": [";
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        if (Node > 0)
+            Fout << ", ";
+        Fout << "{\"id\": " << Node << ", \"color\": " << Colors[Node] << "}";
+    }
+
+    Fout << "],\n\"edges\": [";
+    bool First = true;
+    for (int v1 = 0; v1 < NoNodes; ++v1)
+    {
+        for (int v2 = 0; v2 < v1; ++v2)
+        {
+            if (Graph[v1][v2] > 0)
+            {
+                if (First == false)
+                    Fout << ", ";
+                else
+                    First = false;
+                Fout << "{\"source\": " << v1 << ", \"target\": " << v2 << ", \"weight\": " << Graph[v1][v2] << "}";
+            }
+        }
+    }
+    Fout << "]}\n";
+    Fout.Close();
+}
+//------------------------------------------------------------------------------------------------
+
+void GraphExport::WritePythonInput(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors)
+{
+    BufferedWriter Fout(Path);
+    Fout << '[';
+    bool First = true;
+    for (int v1 = 0; v1 < NoNodes; ++v1)
+    {
+        for (int v2 = 0; v2 < v1; ++v2)
+        {
+            if (Graph[v1][v2] > 0)
+            {
+                if (First == false)
+                    Fout << ", ";
+                else
+                    First = false;
+
+                Fout << '[' << v1 << ", " << v2 << ", { 'label': " << Graph[v1][v2] << " }]";
+            }
+        }
+    }
+    Fout << "]\n{";
+
+    for (int Node = 0; Node < (int)Colors.size(); ++Node)
+    {
+        if (Node > 0)
+            Fout << ", ";
+        Fout << Node << ": { 'value': " << Colors[Node] << " }";
+    }
+    Fout << "}\n";
+    Fout.Close();
+}
+//------------------------------------------------------------------------------------------------
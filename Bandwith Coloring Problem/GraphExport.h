@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Appends into a fixed buffer and hands it to the file in large blocks, so output
+// files are written in linear time without building the whole text in memory.
+class BufferedWriter
+{
+    std::string Path;
+    std::FILE* File;
+    std::vector<char> Buffer;
+    size_t Used = 0;
+public:
+    explicit BufferedWriter(const std::string& Path, size_t Capacity = 1 << 16);
+    ~BufferedWriter();
+
+    BufferedWriter& operator<<(std::string_view Text);
+    BufferedWriter& operator<<(char Symbol);
+    BufferedWriter& operator<<(int Value);
+    BufferedWriter& operator<<(double Value);
+    // Both throw when the data does not reach the file. The destructor closes an
+    // unclosed file without reporting errors, so writers call Close at the end.
+    void Flush();
+    void Close();
+};
+
+// Runs the python rendering scripts on a background thread. Files queued for the
+// same script are handed to one interpreter in batches of up to BatchSize, and the
+// input files are removed once the script succeeds.
+class RenderQueue
+{
+    std::string Python;
+    int BatchSize;
+    std::deque<std::pair<std::string, std::string>> Pending;
+    std::mutex Lock;
+    std::condition_variable Changed;
+    bool Busy = false;
+    bool Stopping = false;
+    std::thread Worker;
+public:
+    explicit RenderQueue(std::string Python = "python", int BatchSize = 16);
+    ~RenderQueue();
+
+    void Enqueue(const std::string& Script, const std::string& InputPath);
+    void Flush();
+private:
+    void WorkerLoop();
+};
+
+struct ExportOptions
+{
+    bool Dot = false;
+    bool Svg = true;
+    bool Json = false;
+    RenderQueue* Renderer = nullptr;
+    // Convergence traces of every LPR replica, off while TraceCapacity is 0.
+    size_t TraceCapacity = 0;
+    int TraceStride = 16;
+    bool TraceBinary = false;
+};
+
+class GraphExport
+{
+public:
+    // Writes BasePath + ".dot" / ".svg" / ".json" as selected in Options and queues
+    // the png rendering when a renderer is attached.
+    static void Export(const std::string& BasePath, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors, const ExportOptions& Options);
+
+    static void WriteDot(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors);
+    static void WriteSvg(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors);
+    static void WriteJson(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors);
+    static void WritePythonInput(const std::string& Path, int NoNodes, const std::vector<std::vector<int>>& Graph, const std::vector<int>& Colors);
+};
@@ -0,0 +1,185 @@
+#include "GraphReduction.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+std::vector<GraphComponent> GraphReduction::SplitComponents(std::vector<std::vector<int>> Edges)
+{
+    int NoNodes = Edges.size();
+    std::vector<int> ComponentOf(NoNodes, -1);
+    std::vector<GraphComponent> Components;
+    std::vector<int> Stack;
+    for (int Root = 0; Root < NoNodes; ++Root)
+    {
+        if (ComponentOf[Root] >= 0)
+            continue;
+
+        int Index = Components.size();
+        Components.emplace_back();
+        ComponentOf[Root] = Index;
+        Stack.push_back(Root);
+        while (!Stack.empty())
+        {
+            int Node = Stack.back();
+            Stack.pop_back();
+            Components[Index].Nodes.push_back(Node);
+            for (int Neighbour = 0; Neighbour < NoNodes; ++Neighbour)
+            {
+                if (Edges[Node][Neighbour] > 0 && ComponentOf[Neighbour] < 0)
+                {
+                    ComponentOf[Neighbour] = Index;
+                    Stack.push_back(Neighbour);
+                }
+            }
+        }
+    }
+
+    for (auto& Component : Components)
+        std::sort(Component.Nodes.begin(), Component.Nodes.end());
+
+    if (Components.size() == 1)
+    {
+        for (int Row = 0; Row < NoNodes; ++Row)
+        {
+            for (int Column = 0; Column < Row; ++Column)
+                Components[0].NoEdges += Edges[Row][Column] > 0;
+        }
+        Components[0].Edges = std::move(Edges);
+        return Components;
+    }
+
+    for (auto& Component : Components)
+        Component = Induce(Edges, std::move(Component.Nodes));
+    return Components;
+}
+//------------------------------------------------------------------------------------------------
+
+GraphComponent GraphReduction::Induce(const std::vector<std::vector<int>>& Edges, std::vector<int> Nodes)
+{
+    GraphComponent Result;
+    int Size = Nodes.size();
+    Result.Edges.assign(Size, std::vector<int>(Size, 0));
+    for (int Row = 0; Row < Size; ++Row)
+    {
+        for (int Column = 0; Column < Size; ++Column)
+            Result.Edges[Row][Column] = Edges[Nodes[Row]][Nodes[Column]];
+        for (int Column = 0; Column < Row; ++Column)
+            Result.NoEdges += Result.Edges[Row][Column] > 0;
+    }
+    Result.Nodes = std::move(Nodes);
+    return Result;
+}
+//------------------------------------------------------------------------------------------------
+
+std::vector<PeeledNode> GraphReduction::PeelLowDegree(const std::vector<std::vector<int>>& Edges, int NoColors)
+{
+    int NoNodes = Edges.size();
+    std::vector<int64_t> Forbidden(NoNodes, 0);
+    std::vector<char> Queued(NoNodes, 0);
+    std::vector<char> Removed(NoNodes, 0);
+    std::vector<int> Queue;
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        for (int Neighbour = 0; Neighbour < NoNodes; ++Neighbour)
+        {
+            if (Edges[Node][Neighbour] > 0 && Neighbour != Node)
+                Forbidden[Node] += 2 * Edges[Node][Neighbour] - 1;
+        }
+        // A self loop cannot be satisfied by any color, such a node stays in the search.
+        if (Forbidden[Node] < NoColors && Edges[Node][Node] == 0)
+        {
+            Queued[Node] = 1;
+            Queue.push_back(Node);
+        }
+    }
+
+    std::vector<PeeledNode> Peeled;
+    for (size_t Head = 0; Head < Queue.size(); ++Head)
+    {
+        int Node = Queue[Head];
+        Removed[Node] = 1;
+        Peeled.push_back({ Node, {} });
+        for (int Neighbour = 0; Neighbour < NoNodes; ++Neighbour)
+        {
+            int Weight = Edges[Node][Neighbour];
+            if (Weight == 0 || Removed[Neighbour])
+                continue;
+            Peeled.back().Neighbours.push_back({ Neighbour, Weight });
+            Forbidden[Neighbour] -= 2 * Weight - 1;
+            if (!Queued[Neighbour] && Forbidden[Neighbour] < NoColors && Edges[Neighbour][Neighbour] == 0)
+            {
+                Queued[Neighbour] = 1;
+                Queue.push_back(Neighbour);
+            }
+        }
+    }
+    return Peeled;
+}
+//------------------------------------------------------------------------------------------------
+
+void GraphReduction::ColorPeeled(const std::vector<PeeledNode>& Peeled, int NoColors, std::vector<int>& Solution)
+{
+    std::vector<std::pair<int, int>> Windows;
+    for (auto It = Peeled.rbegin(); It != Peeled.rend(); ++It)
+    {
+        Windows.clear();
+        for (const auto& [Neighbour, Weight] : It->Neighbours)
+            Windows.push_back({ Solution[Neighbour] - Weight + 1, Solution[Neighbour] + Weight - 1 });
+        std::sort(Windows.begin(), Windows.end());
+
+        int Color = 1;
+        for (const auto& Window : Windows)
+        {
+            if (Window.first > Color)
+                break;
+            Color = std::max(Color, Window.second + 1);
+        }
+        Solution[It->Node] = std::min(Color, NoColors);
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+std::vector<int> GraphReduction::ReverseCuthillMcKee(const std::vector<std::vector<int>>& Edges)
+{
+    int NoNodes = Edges.size();
+    std::vector<int> Degree(NoNodes, 0);
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        for (int Neighbour = 0; Neighbour < NoNodes; ++Neighbour)
+            Degree[Node] += Edges[Node][Neighbour] > 0 && Neighbour != Node;
+    }
+    auto ByDegree = [&](int First, int Second) { return Degree[First] < Degree[Second]; };
+
+    std::vector<int> Roots(NoNodes);
+    std::iota(Roots.begin(), Roots.end(), 0);
+    std::stable_sort(Roots.begin(), Roots.end(), ByDegree);
+
+    std::vector<int> Order;
+    Order.reserve(NoNodes);
+    std::vector<char> Visited(NoNodes, 0);
+    for (int Root : Roots)
+    {
+        if (Visited[Root])
+            continue;
+        Visited[Root] = 1;
+        Order.push_back(Root);
+        for (size_t Head = Order.size() - 1; Head < Order.size(); ++Head)
+        {
+            int Node = Order[Head];
+            size_t First = Order.size();
+            for (int Neighbour = 0; Neighbour < NoNodes; ++Neighbour)
+            {
+                if (Edges[Node][Neighbour] > 0 && !Visited[Neighbour])
+                {
+                    Visited[Neighbour] = 1;
+                    Order.push_back(Neighbour);
+                }
+            }
+            std::stable_sort(Order.begin() + First, Order.end(), ByDegree);
+        }
+    }
+    std::reverse(Order.begin(), Order.end());
+    return Order;
+}
+//------------------------------------------------------------------------------------------------
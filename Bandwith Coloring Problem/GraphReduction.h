@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+// A part of an instance handed to the search on its own: the original ids of its
+// nodes and the edge matrix induced on them, in the same order. The ids ascend
+// unless LPRParameters::ReorderNodes put them in reverse Cuthill-McKee order.
+struct GraphComponent
+{
+    std::vector<int> Nodes;
+    int NoEdges = 0;
+    std::vector<std::vector<int>> Edges;
+};
+
+// A node removed by PeelLowDegree with the (neighbour, weight) edges it still had at
+// that point; those neighbours are all colored before it.
+struct PeeledNode
+{
+    int Node;
+    std::vector<std::pair<int, int>> Neighbours;
+};
+
+// Preprocessing of a bandwidth coloring instance before it reaches LPR.
+class GraphReduction
+{
+public:
+    // Connected components, ordered by their smallest node. A connected graph is
+    // returned as a single component that takes over Edges without a copy.
+    static std::vector<GraphComponent> SplitComponents(std::vector<std::vector<int>> Edges);
+
+    // Subgraph induced on Nodes, numbered in the given order.
+    static GraphComponent Induce(const std::vector<std::vector<int>>& Edges, std::vector<int> Nodes);
+
+    // Repeatedly removes nodes whose remaining neighbours forbid fewer than NoColors
+    // colors in total (2w - 1 per edge), in removal order. Any coloring of the rest
+    // extends to them by ColorPeeled.
+    static std::vector<PeeledNode> PeelLowDegree(const std::vector<std::vector<int>>& Edges, int NoColors);
+
+    // Reverse Cuthill-McKee order, Order[NewId] = node. Every component is traversed
+    // breadth first from a node of minimum degree, neighbours by increasing degree, so
+    // adjacent nodes get close ids.
+    static std::vector<int> ReverseCuthillMcKee(const std::vector<std::vector<int>>& Edges);
+
+    // Gives the peeled nodes, in reverse removal order, the smallest color that is
+    // free of all their neighbours' windows.
+    static void ColorPeeled(const std::vector<PeeledNode>& Peeled, int NoColors, std::vector<int>& Solution);
+};
@@ -1,725 +1,1073 @@
-#include "LPR.h"
-
-LPR::LPR(int NoNodes, int NoEdges, int NoColors, int PopulationSize, std::vector<std::vector<int>> Edges)
-{
-    this->NoNodes = NoNodes;
-    this->NoEdges = NoEdges;
-    this->NoColors = NoColors;
-    this->PopulationSize = PopulationSize;
-    this->Edges = Edges;
-    PenaltyMatrix.resize(NoNodes);
-
-    for (int line = 0; line < NoNodes; ++line)
-    {
-        PenaltyMatrix[line].resize(NoNodes);
-        for (int col = 0; col < line; ++col)
-            PenaltyMatrix[line][col] = 0;
-    }
-
-    InitializeVariables();
-}
-//------------------------------------------------------------------------------------------------
-
-std::vector<int> LPR::Solve()
-{
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    int MaxIterations = 2;
-    int Iterations = 0;
-    std::vector<int> BestSol, WorstSol;
-
-    do
-    {
-        InitializePopulation();
-        if (Iterations > 0)
-        {
-            int MaxConstraintViolation = INT_MAX;
-            for (auto Sol : Population)
-            {
-                int Sum = SumConstraintViolations(Sol);
-                if (Sum > MaxConstraintViolation)
-                {
-                    MaxConstraintViolation = Sum;
-                    WorstSol = Sol;
-                }
-            }
-
-            Population.insert(BestSol);
-            Population.erase(WorstSol);
-        }
-        
-        int MinConstraintViolation = INT_MAX;
-        for (auto Sol : Population)
-        {
-            int Sum = SumConstraintViolations(Sol);
-            if (Sum < MinConstraintViolation)
-            {
-                MinConstraintViolation = Sum;
-                BestSol = Sol;
-            }
-        }
-
-        std::set<std::pair<std::vector<int>, std::vector<int>>> PairSet;
-        for (auto It1 = Population.begin(); It1 != Population.end(); ++It1)
-            for (auto It2 = std::next(It1); It2 != Population.end(); ++It2)
-                PairSet.insert({ *It1, *It2 });
-
-        while (PairSet.size() > 0)
-        {
-            std::uniform_int_distribution<int> dist(0, PairSet.size() - 1);
-            auto It = std::next(PairSet.begin(), dist(gen));
-            std::pair<std::vector<int>, std::vector<int>> SelectedPair = *It;
-
-            PairSet.erase(*It);
-            std::vector<int> FirstChild = MixedPathRelinking(SelectedPair.first, SelectedPair.second);
-            std::vector<int> SecondChild = MixedPathRelinking(SelectedPair.second, SelectedPair.first);
-
-            Improvement_and_Updating(FirstChild, BestSol, PairSet);
-            Improvement_and_Updating(SecondChild, BestSol, PairSet);
-
-            if (SumConstraintViolations(BestSol) == 0)
-                return BestSol;
-        }
-
-        ++Iterations;
-    } while (Iterations < MaxIterations);
-
-    return std::vector<int>();
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::InitializeVariables()
-{
-    this->Alpha0 = 2000;
-    this->Alpha = 10000;
-    this->MaxPenaltyWeight = 30;
-    this->ScalingFactor = 0.4f;
-    this->Tmax = 50;
-    this->Pmax = 15;
-    std::vector<int> A = { 1, 2, 1, 4, 1, 2, 1, 8, 1, 2, 1, 4, 1, 2, 1 };
-
-    TabuTenure.resize(Pmax);
-    TabuTenureInterval.resize(Pmax);
-    for (int Index = 0; Index < Pmax; ++Index)
-    {
-        TabuTenure[Index] = Tmax * A[Index] / 8;
-        TabuTenureInterval[Index] = Tmax * A[Index] / 2;
-    }
-
-    AdjList.resize(NoNodes);
-    for (int V1 = 0; V1 < NoNodes; ++V1)
-    {
-        std::vector<int> Ngh;
-        for (int V2 = 0; V2 < NoNodes; ++V2)
-        {
-            if (Edges[V1][V2] > 0)
-                Ngh.push_back(V2);
-        }
-        AdjList[V1] = Ngh;
-    }
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::InitializePopulation()
-{
-    std::vector<std::vector<int>> LargerPopulation;
-    for (int Index = 0; Index < 3 * PopulationSize; ++Index)
-    {
-        std::vector<int> RandSol = GenerateRandomSolution();
-
-        //TabuSearch(RandSol, false);
-        TabuSearchImpr(RandSol, false);
-
-        LargerPopulation.push_back(RandSol);
-    }
-
-    auto CompareLambda = [&](const std::vector<int> s1, const std::vector<int> s2) {
-        return SumConstraintViolations(s1) < SumConstraintViolations(s2);
-    };
-
-    sort(LargerPopulation.begin(), LargerPopulation.end(), CompareLambda);
-    LargerPopulation.resize(PopulationSize);
-
-    Population.clear();
-    for (auto Sol : LargerPopulation)
-        Population.insert(Sol);
-}
-//------------------------------------------------------------------------------------------------
-
-int LPR::SumConstraintViolations(std::vector<int> Solution)
-{
-    if (Solution.size() == 0)
-        return INT_MAX;
-
-    int Sum = 0;
-    for (int v1 = 0; v1 < NoNodes; ++v1)
-    {
-        for (int v2 = 0; v2 < v1; ++v2)
-        {
-            Sum = Sum + std::max(0, Edges[v1][v2] - std::abs(Solution[v1] - Solution[v2]));
-        }
-    }
-
-    return Sum;
-}
-//------------------------------------------------------------------------------------------------
-
-int LPR::AugmentedSumConstraintViolations(std::vector<int> Solution)
-{
-    if (Solution.size() == 0)
-        return INT_MAX;
-
-    int Sum = SumConstraintViolations(Solution);
-    for (int v1 = 0; v1 < NoNodes; ++v1)
-    {
-        for (int v2 = 0; v2 < v1; ++v2)
-        {
-            if (std::abs(Solution[v1] - Solution[v2]) < Edges[v1][v2])
-            {
-                Sum = Sum + PenaltyMatrix[v1][v2];
-            }
-        }
-    }
-    return Sum;
-}
-//------------------------------------------------------------------------------------------------
-
-int LPR::DistanceHamming(std::vector<int> Solution)
-{
-
-    int MinCount = INT_MAX;
-    for (auto CurrSol : Population)
-    {
-        int Count = 0;
-        for (int Index = 0; Index < Solution.size(); ++Index)
-            if (CurrSol[Index] != Solution[Index])
-                ++Count;
-
-        MinCount = std::min(MinCount, Count);
-    }
-
-    return MinCount;
-}
-//------------------------------------------------------------------------------------------------
-
-std::vector<int> LPR::GenerateRandomSolution()
-{
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dist(1, NoColors);
-
-    std::vector<int> Solution;
-    Solution.resize(NoNodes);
-
-    for (int node = 0; node < NoNodes; ++node)
-    {
-        Solution[node] = dist(gen);
-    }
-
-    return Solution;
-}
-//------------------------------------------------------------------------------------------------
-
-std::vector<int> LPR::MixedPathRelinking(std::vector<int> FirstParent, std::vector<int> SecondParent)
-{
-    std::vector<int> DiffPos;
-    for (int Index = 0; Index < NoNodes; ++Index)
-        if (FirstParent[Index] != SecondParent[Index])
-            DiffPos.push_back(Index);
-
-    int DiffPosLen = DiffPos.size();
-    std::vector<int> Last, PrevLast, TempSol;
-    int SumConstraintsLast, SumConstraintsPrevLast, TempSum;
-
-    PrevLast = FirstParent;
-    Last = SecondParent;
-    SumConstraintsPrevLast = SumConstraintViolations(PrevLast);
-    SumConstraintsLast = SumConstraintViolations(Last);
-
-    int CurrentLen = 2;
-    while (DiffPos.size() > 0)
-    {
-        std::vector<int> CurrentChoice;
-        if (CurrentLen % 2 == 0)
-            CurrentChoice = SecondParent;
-        else
-            CurrentChoice = FirstParent;
-
-        int BestSubstitutionCost = INT_MAX;
-        int BestSubstitutionIndex = INT_MAX;
-
-        for (int Index = 0; Index < DiffPos.size(); ++Index)
-        {
-            int CurrentDiffNode = DiffPos[Index];
-            int AuxSum = SumConstraintsPrevLast;
-            for (int Neighbour : AdjList[CurrentDiffNode])
-            {
-                AuxSum = AuxSum - std::max(0, Edges[CurrentDiffNode][Neighbour] - std::abs(PrevLast[CurrentDiffNode] - PrevLast[Neighbour]))
-                        + std::max(0, Edges[CurrentDiffNode][Neighbour] - std::abs(CurrentChoice[CurrentDiffNode] - CurrentChoice[Neighbour]));
-            }
-
-            if (AuxSum < BestSubstitutionCost)
-            {
-                BestSubstitutionCost = AuxSum;
-                BestSubstitutionIndex = Index;
-            }
-        }
-        
-        TempSol = PrevLast;
-        TempSol[DiffPos[BestSubstitutionIndex]] = CurrentChoice[DiffPos[BestSubstitutionIndex]];
-        PrevLast = Last;
-        Last = TempSol;
-
-        TempSum = BestSubstitutionCost;
-        SumConstraintsPrevLast = SumConstraintsLast;
-        SumConstraintsLast = TempSum;
-
-        DiffPos.erase(DiffPos.begin() + BestSubstitutionIndex);
-        ++CurrentLen;
-    }
-    return Last;
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::TabuSearchImpr(std::vector<int>& Solution, bool IsAugmented)
-{
-    int IntervalIteration = 0;
-    int Interval = 0;
-    int CurrentIteration = 0;
-    int CurrentDepth = 0;
-    std::vector<int> BestSol = Solution;
-    std::map<std::pair<int, int>, int> TabuTable;
-
-    int LowestConstraintViolation = SumConstraintViolations(Solution);
-    int SolutionCost, MaxDepth;
-    if (IsAugmented)
-    {
-        SolutionCost = AugmentedSumConstraintViolations(Solution);
-        MaxDepth = Alpha0;
-    }
-    else
-    {
-        SolutionCost = SumConstraintViolations(Solution);
-        MaxDepth = Alpha;
-    }
-
-    std::vector<std::vector<int>> ColorChangeSum;
-    std::vector<std::vector<int>> ColorChangeWeightSum;
-    InitializePrecalcMatrixes(Solution, ColorChangeSum, ColorChangeWeightSum, IsAugmented);
-    
-    int NoRandCandidates = 100;
-    int BestCandidateValue;
-    int BestCandidateValueTabu;
-    std::vector<std::pair<int, int>> BestCandidateList;
-    std::vector<std::pair<int, int>> BestCandidateListTabu;
-    std::pair<int, int> CurrChoice;
-    std::pair<int, int> BestCandidate;
-
-    while (CurrentDepth < MaxDepth)
-    {
-        if (LowestConstraintViolation == 0)
-        {
-            Solution = BestSol;
-            return;
-        }
-
-        BestCandidateValue = INT_MAX;
-        BestCandidateValueTabu = INT_MAX;
-
-        BestCandidateList.clear();
-        BestCandidateListTabu.clear();
-        for (int Node = 0; Node < NoNodes; ++Node)
-        {
-            int Skip = false;
-
-            if (ColorChangeSum[Node][Solution[Node]] == 0)
-            {
-                if (IsAugmented)
-                {
-                    if (ColorChangeWeightSum[Node][Solution[Node]] == 0)
-                        Skip = true;
-                }
-                else Skip = true;
-            }
-
-            if (Skip)
-                continue;
-
-            for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
-            {
-                if (Solution[Node] == NewColor)
-                    continue;
-
-                CurrChoice = { Node, NewColor };
-
-                bool IsTabu = false;
-                if (TabuTable.count(CurrChoice))
-                {
-                    int OutIteration = TabuTable[CurrChoice];
-                    if (OutIteration > CurrentIteration)
-                    {
-                        IsTabu = true;
-                    }
-                    else
-                    {
-                        TabuTable.erase(CurrChoice);
-                    }
-                }
-
-                int Delta = ColorChangeSum[Node][Solution[Node]] - ColorChangeSum[Node][NewColor];
-                if (IsAugmented)
-                    Delta += ColorChangeWeightSum[Node][Solution[Node]] - ColorChangeWeightSum[Node][NewColor];
-
-                if (!IsTabu)
-                {
-                    if (SolutionCost - Delta < BestCandidateValue)
-                    {
-                        BestCandidateValue = SolutionCost - Delta;
-                        BestCandidateList.clear();
-                        BestCandidateList.push_back(CurrChoice);
-                    }
-                    else if (SolutionCost - Delta == BestCandidateValue && BestCandidateList.size() < NoRandCandidates)
-                    {
-                        BestCandidateList.push_back(CurrChoice);
-                    }
-                }
-                else
-                {
-                    if (SolutionCost - Delta < BestCandidateValueTabu)
-                    {
-                        BestCandidateValueTabu = SolutionCost - Delta;
-                        BestCandidateListTabu.clear();
-                        BestCandidateListTabu.push_back(CurrChoice);
-                    }
-                    else if (SolutionCost - Delta == BestCandidateValueTabu && BestCandidateListTabu.size() < NoRandCandidates)
-                    {
-                        BestCandidateListTabu.push_back(CurrChoice);
-                    }
-                }
-            }
-        }
-
-        if (BestCandidateList.size() == 0 && BestCandidateListTabu.size() == 0)
-        {
-            Solution = BestSol;
-            return;
-        }
-
-        if (BestCandidateList.size() == 0 || BestCandidateValueTabu < std::min(BestCandidateValue, LowestConstraintViolation))
-        {
-            //Aspiration
-            BestCandidate = BestCandidateListTabu[rand() % BestCandidateListTabu.size()];
-            BestCandidateValue = BestCandidateValueTabu;
-        }
-        else
-        {
-            BestCandidate = BestCandidateList[rand() % BestCandidateList.size()];
-        }
-
-        TabuTable[BestCandidate] = CurrentIteration + TabuTenure[Interval] + rand() % 3;
-        ++IntervalIteration;
-        if (IntervalIteration > TabuTenureInterval[Interval])
-        {
-            Interval = (Interval + 1) % Pmax;
-            IntervalIteration = 0;
-        }
-
-        SolutionCost = BestCandidateValue;
-        UpdatePrecalcMatrixes(Solution, BestCandidate, ColorChangeSum, ColorChangeWeightSum, IsAugmented);
-        Solution[BestCandidate.first] = BestCandidate.second;
-
-
-        if (BestCandidateValue < LowestConstraintViolation)
-        {
-            LowestConstraintViolation = BestCandidateValue;
-            BestSol = Solution;
-            CurrentDepth = 0;
-        }
-        else
-        {
-            ++CurrentDepth;
-        }
-
-        ++CurrentIteration;
-    }
-
-    Solution = BestSol;
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::TabuSearch(std::vector<int>& Solution, bool IsAugmented)
-{
-    int IntervalIteration = 0;
-    int Interval = 0;
-    int CurrentIteration = 0;
-    int CurrentDepth = 0;
-    std::vector<int> BestSol = Solution;
-    std::map<std::pair<int, int>, int> TabuTable;
-
-    int LowestConstraintViolation;
-    if (IsAugmented)
-        LowestConstraintViolation = AugmentedSumConstraintViolations(Solution);
-    else
-        LowestConstraintViolation = SumConstraintViolations(Solution);
-
-    while (CurrentDepth < Alpha)
-    {
-        if (LowestConstraintViolation == 0)
-        {
-            Solution = BestSol;
-            return;
-        }
-
-        int BestCandidateValue = INT_MAX;
-        std::vector<std::pair<int, int>> BestCandidateList;
-
-        for (int Node = 0; Node < NoNodes; ++Node)
-        {
-            for (int Neighbour = 0; Neighbour < NoNodes; ++Neighbour)
-            {
-                if (Edges[Node][Neighbour] > 0 && std::abs(Solution[Node] - Solution[Neighbour]) < Edges[Node][Neighbour])
-                {
-                    for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
-                    {
-                        if (Solution[Node] == NewColor)
-                            continue;
-
-                        std::pair<int, int> CurrChoice = { Node, NewColor };
-
-                        if (TabuTable.count(CurrChoice))
-                        {
-                            int OutIteration = TabuTable[CurrChoice];
-                            if (OutIteration >= CurrentIteration)
-                            {
-                                continue;
-                            }
-                            else
-                            {
-                                TabuTable.erase(CurrChoice);
-                            }
-                        }
-
-                        std::vector<int> TmpSol = Solution;
-                        TmpSol[CurrChoice.first] = CurrChoice.second;
-                        int TmpCost;
-                        if (IsAugmented)
-                            TmpCost = AugmentedSumConstraintViolations(TmpSol);
-                        else
-                            TmpCost = SumConstraintViolations(TmpSol);
-
-                        if (TmpCost < BestCandidateValue)
-                        {
-                            BestCandidateValue = TmpCost;
-                            BestCandidateList.clear();
-                            BestCandidateList.push_back(CurrChoice);
-                        }
-                        else if (TmpCost == BestCandidateValue)
-                        {
-                            BestCandidateList.push_back(CurrChoice);
-                        }
-                    }
-                }
-            }
-        }
-
-        if (BestCandidateList.size() == 0)
-        {
-            Solution = BestSol;
-            return;
-        }
-
-        std::pair<int, int> BestCandidate = BestCandidateList[rand() % BestCandidateList.size()];
-        TabuTable[BestCandidate] = CurrentIteration + TabuTenure[Interval] + rand() % 3;
-        ++IntervalIteration;
-        if (IntervalIteration > TabuTenureInterval[Interval])
-        {
-            Interval = (Interval + 1) % Pmax;
-            IntervalIteration = 0;
-        }
-
-        Solution[BestCandidate.first] = BestCandidate.second;
-
-
-        if (BestCandidateValue < LowestConstraintViolation)
-        {
-            LowestConstraintViolation = BestCandidateValue;
-            BestSol = Solution;
-            CurrentDepth = 0;
-        }
-        else
-            ++CurrentDepth;
-
-        ++CurrentIteration;
-    }
-
-    Solution = BestSol;
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::TwoPhaseTabuSearch(std::vector<int>& Solution)
-{
-    //TabuSearch(Solution, true);
-    //TabuSearch(Solution, false);
-    TabuSearchImpr(Solution, true);
-    TabuSearchImpr(Solution, false);
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::Improvement_and_Updating(std::vector<int>& CurrentSol, std::vector<int>& BestSol, std::set<std::pair<std::vector<int>, std::vector<int>>>& PairSet)
-{
-    TwoPhaseTabuSearch(CurrentSol);
-    UpdatePenaltyMatrix(CurrentSol);   
-    
-    if (SumConstraintViolations(CurrentSol) < SumConstraintViolations(BestSol))
-        BestSol = CurrentSol;
-    
-    int MaxConstraintViolation = 0;
-    std::vector<int> WorstSol;
-    for (auto Sol : Population)
-    {
-        int Sum = SumConstraintViolations(Sol);
-        if (Sum > MaxConstraintViolation)
-        {
-            MaxConstraintViolation = Sum;
-            WorstSol = Sol;
-        }
-    }
-
-    if (SumConstraintViolations(CurrentSol) < SumConstraintViolations(WorstSol) &&
-        DistanceHamming(CurrentSol) > 0.1f * NoNodes)
-    {
-        Population.insert(CurrentSol);
-        Population.erase(WorstSol);
-        for (auto KSol : Population)
-        {
-            if (PairSet.find({ WorstSol, KSol }) != PairSet.end())
-            {
-                PairSet.erase({ WorstSol, KSol });
-                PairSet.insert({ CurrentSol, KSol });
-            }
-
-            if (PairSet.find({ KSol, WorstSol }) != PairSet.end())
-            {
-                PairSet.erase({ KSol, WorstSol });
-                PairSet.insert({ KSol, CurrentSol });
-            }
-
-        }
-
-    }
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::UpdatePenaltyMatrix(std::vector<int> Solution)
-{
-    int MaxPenalty = 0;
-    for (int v1 = 0; v1 < NoNodes; ++v1)
-    {
-        for (int v2 = 0; v2 < v1; ++v2)
-        {
-            if (Edges[v1][v2] > 0 && std::abs(Solution[v1] - Solution[v2]) < Edges[v1][v2])
-            {
-                ++PenaltyMatrix[v1][v2];
-                ++PenaltyMatrix[v2][v1];
-            }
-
-            MaxPenalty = std::max(MaxPenalty, PenaltyMatrix[v1][v2]);
-        }
-    }
-
-    if (MaxPenalty > MaxPenaltyWeight)
-    {
-        for (int v1 = 0; v1 < NoNodes; ++v1)
-        {
-            for (int v2 = 0; v2 < v1; ++v2)
-            {
-                PenaltyMatrix[v1][v2] = std::floor(ScalingFactor * PenaltyMatrix[v1][v2]);
-                PenaltyMatrix[v2][v1] = std::floor(ScalingFactor * PenaltyMatrix[v2][v1]);
-            }
-        }
-    }
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::InitializePrecalcMatrixes(std::vector<int> Solution, std::vector<std::vector<int>>& ColorChangeSum, std::vector<std::vector<int>>& ColorChangeWeightSum, bool IsAugmented)
-{
-    ColorChangeSum.resize(NoNodes);
-    for (int Node = 0; Node < NoNodes; ++Node)
-    {
-        ColorChangeSum[Node].resize(NoColors + 1);
-        for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
-        {
-            ColorChangeSum[Node][NewColor] = 0;
-            for (auto Neighbour : AdjList[Node])
-            {
-                ColorChangeSum[Node][NewColor] += std::max(0, Edges[Node][Neighbour] - std::abs(Solution[Neighbour] - NewColor));
-            }
-        }
-    }
-
-    if (IsAugmented)
-    {
-        ColorChangeWeightSum.resize(NoNodes);
-        for (int Node = 0; Node < NoNodes; ++Node)
-        {
-            ColorChangeWeightSum[Node].resize(NoColors + 1);
-            for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
-            {
-                ColorChangeWeightSum[Node][NewColor] = 0;
-                for (auto Neighbour : AdjList[Node])
-                {
-                    if(std::abs(Solution[Neighbour] - NewColor) < Edges[Node][Neighbour])
-                        ColorChangeWeightSum[Node][NewColor] += PenaltyMatrix[Node][Neighbour];
-                }
-            }
-        }
-    }
-}
-//------------------------------------------------------------------------------------------------
-
-void LPR::UpdatePrecalcMatrixes(std::vector<int> Solution, std::pair<int, int> BestCandidate, std::vector<std::vector<int>>&ColorChangeSum, std::vector<std::vector<int>>& ColorChangeWeightSum, bool IsAugmented)
-{
-    int Start, End;
-    int OldColor = Solution[BestCandidate.first];
-    for (auto Neighbour : AdjList[BestCandidate.first])
-    {
-        Start = std::max(1, OldColor - Edges[BestCandidate.first][Neighbour] + 1);
-        End = std::min(NoColors, OldColor + Edges[BestCandidate.first][Neighbour] - 1);
-        for (int NewColor = Start; NewColor <= End; ++NewColor)
-        {
-            ColorChangeSum[Neighbour][NewColor] -= (Edges[Neighbour][BestCandidate.first] - std::abs(OldColor - NewColor));
-        }
-
-        Start = std::max(1, BestCandidate.second - Edges[BestCandidate.first][Neighbour] + 1);
-        End = std::min(NoColors, BestCandidate.second + Edges[BestCandidate.first][Neighbour] - 1);
-
-        for (int NewColor = Start; NewColor <= End; ++NewColor)
-        {
-            ColorChangeSum[Neighbour][NewColor] += (Edges[Neighbour][BestCandidate.first] - std::abs(BestCandidate.second - NewColor));
-        }
-
-    }
-
-    if (IsAugmented)
-    {
-        for (auto Neighbour : AdjList[BestCandidate.first])
-        {
-            Start = std::max(1, OldColor - Edges[BestCandidate.first][Neighbour] + 1);
-            End = std::min(NoColors, OldColor + Edges[BestCandidate.first][Neighbour] - 1);
-            for (int NewColor = Start; NewColor <= End; ++NewColor)
-            {
-                ColorChangeWeightSum[Neighbour][NewColor] -= PenaltyMatrix[Neighbour][BestCandidate.first];
-            }
-
-            Start = std::max(1, BestCandidate.second - Edges[BestCandidate.first][Neighbour] + 1);
-            End = std::min(NoColors, BestCandidate.second + Edges[BestCandidate.first][Neighbour] - 1);
-
-            for (int NewColor = Start; NewColor <= End; ++NewColor)
-            {
-                ColorChangeWeightSum[Neighbour][NewColor] += PenaltyMatrix[Neighbour][BestCandidate.first];
-            }
-        }
-    }
-}
-//------------------------------------------------------------------------------------------------
+#include "LPR.h"
+
+LPRSearchBase::LPRSearchBase(int NoNodes, int NoEdges, int NoColors, const LPRParameters& Parameters, unsigned Seed)
+    : Gen(Seed)
+{
+    this->NoNodes = NoNodes;
+    this->NoEdges = NoEdges;
+    this->NoColors = NoColors;
+    InitializeVariables(Parameters);
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+LPRSearch<Color, Total>::LPRSearch(int NoNodes, int NoEdges, int NoColors, const std::vector<std::vector<int>>& Edges, const LPRParameters& Parameters, unsigned Seed)
+    : LPRSearchBase(NoNodes, NoEdges, NoColors, Parameters, Seed)
+{
+    InitializeAdjacency(Edges);
+
+    int MaxDegree = 0;
+    for (int Node = 0; Node < NoNodes; ++Node)
+        MaxDegree = std::max(MaxDegree, AdjOffsets[Node + 1] - AdjOffsets[Node]);
+    Workspace.Reserve(NoNodes, NoColors, MaxDegree, NoRandCandidates, GapSamples);
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+std::vector<int> LPRSearch<Color, Total>::Solve(std::chrono::steady_clock::time_point Start)
+{
+    Deadline = Start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(TimeLimit));
+    TraceBestCost = INT_MAX;
+    int Iterations = 0;
+    SolutionType BestSol, WorstSol;
+
+    do
+    {
+        InitializePopulation();
+        if (Iterations > 0)
+        {
+            LPR_COUNT(Restarts, 1);
+            int MaxConstraintViolation = INT_MAX;
+            for (const auto& Sol : Population)
+            {
+                int Sum = SumConstraintViolations(Sol);
+                if (Sum > MaxConstraintViolation)
+                {
+                    MaxConstraintViolation = Sum;
+                    WorstSol = Sol;
+                }
+            }
+
+            Population.insert(BestSol);
+            Population.erase(WorstSol);
+            LPR_COUNT(PopulationReplacements, 1);
+        }
+        
+        int MinConstraintViolation = INT_MAX;
+        for (const auto& Sol : Population)
+        {
+            int Sum = SumConstraintViolations(Sol);
+            if (Sum < MinConstraintViolation)
+            {
+                MinConstraintViolation = Sum;
+                BestSol = Sol;
+            }
+        }
+
+        PairSetType PairSet;
+        for (auto It1 = Population.begin(); It1 != Population.end(); ++It1)
+            for (auto It2 = std::next(It1); It2 != Population.end(); ++It2)
+                PairSet.insert({ *It1, *It2 });
+
+        SolutionType FirstChild, SecondChild;
+        while (PairSet.size() > 0)
+        {
+            std::uniform_int_distribution<int> dist(0, PairSet.size() - 1);
+            auto SelectedNode = PairSet.extract(std::next(PairSet.begin(), dist(Gen)));
+            const auto& SelectedPair = SelectedNode.value();
+
+            MixedPathRelinking(SelectedPair.first, SelectedPair.second, Workspace, FirstChild);
+            MixedPathRelinking(SelectedPair.second, SelectedPair.first, Workspace, SecondChild);
+
+            Improvement_and_Updating(FirstChild, BestSol, PairSet);
+            Improvement_and_Updating(SecondChild, BestSol, PairSet);
+
+            if (Trace != nullptr)
+            {
+                int ChildCost = std::min(SumConstraintViolations(FirstChild), SumConstraintViolations(SecondChild));
+                TraceBestCost = std::min(TraceBestCost, SumConstraintViolations(BestSol));
+                Trace->Record(TabuIterations, ChildCost, TraceBestCost, ChildCost, TracePhase::Relinking, true);
+            }
+
+            if (SumConstraintViolations(BestSol) == 0)
+                return std::vector<int>(BestSol.begin(), BestSol.end());
+            if (TimeExpired())
+                return std::vector<int>();
+        }
+
+        ++Iterations;
+    } while (Iterations < MaxRestarts && !TimeExpired());
+
+    return std::vector<int>();
+}
+//------------------------------------------------------------------------------------------------
+
+void LPRSearchBase::InitializeVariables(const LPRParameters& Parameters)
+{
+    Parameters.Validate();
+    this->PopulationSize = Parameters.PopulationSize;
+    this->Alpha0 = Parameters.Alpha0;
+    this->Alpha = Parameters.Alpha;
+    this->MaxPenaltyWeight = Parameters.MaxPenaltyWeight;
+    this->ScalingFactor = Parameters.ScalingFactor;
+    this->Tmax = Parameters.Tmax;
+    this->NoRandCandidates = Parameters.NoRandCandidates;
+    this->MaxRestarts = Parameters.MaxRestarts;
+    this->TimeLimit = Parameters.TimeLimit;
+    this->ExactNeighbourhood = Parameters.ExactNeighbourhood;
+    this->GapSamples = Parameters.GapSamples;
+    this->Pmax = 15;
+    std::vector<int> A = { 1, 2, 1, 4, 1, 2, 1, 8, 1, 2, 1, 4, 1, 2, 1 };
+
+    TabuTenure.resize(Pmax);
+    TabuTenureInterval.resize(Pmax);
+    for (int Index = 0; Index < Pmax; ++Index)
+    {
+        TabuTenure[Index] = Tmax * A[Index] / 8;
+        TabuTenureInterval[Index] = Tmax * A[Index] / 2;
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::InitializeAdjacency(const std::vector<std::vector<int>>& Edges)
+{
+    AdjOffsets.assign(1, 0);
+    for (int V1 = 0; V1 < NoNodes; ++V1)
+    {
+        for (int V2 = 0; V2 < NoNodes; ++V2)
+        {
+            if (Edges[V1][V2] > 0)
+            {
+                AdjNodes.push_back(V2);
+                AdjWeights.push_back((Color)Edges[V1][V2]);
+            }
+        }
+        AdjOffsets.push_back((int)AdjNodes.size());
+    }
+
+    // Both entries of an edge share its id; the twin of (V1, V2) is found in the sorted list of V2.
+    // Self loops never collect a penalty and point at the zero slot past the last edge.
+    AdjEdge.assign(AdjNodes.size(), -1);
+    for (int V1 = 0; V1 < NoNodes; ++V1)
+    {
+        for (int It = AdjOffsets[V1]; It < AdjOffsets[V1 + 1] && AdjNodes[It] < V1; ++It)
+        {
+            int V2 = AdjNodes[It];
+            auto Twin = std::lower_bound(AdjNodes.begin() + AdjOffsets[V2], AdjNodes.begin() + AdjOffsets[V2 + 1], V1);
+            assert(Twin != AdjNodes.begin() + AdjOffsets[V2 + 1] && *Twin == V1);
+            AdjEdge[It] = AdjEdge[Twin - AdjNodes.begin()] = (int)EdgeFrom.size();
+            EdgeFrom.push_back(V1);
+            EdgeTo.push_back(V2);
+            EdgeWeight.push_back(AdjWeights[It]);
+        }
+    }
+    for (auto& Edge : AdjEdge)
+    {
+        if (Edge < 0)
+            Edge = (int)EdgeFrom.size();
+    }
+    EdgePenalty.assign(EdgeFrom.size() + 1, 0);
+    EdgeEpoch.assign(EdgeFrom.size(), 0);
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::InitializePopulation()
+{
+    LPR_TIME(InitSeconds);
+    std::vector<SolutionType> LargerPopulation;
+    for (int Index = 0; Index < 3 * PopulationSize; ++Index)
+    {
+        SolutionType RandSol = GenerateRandomSolution();
+
+        TabuSearchImpr<Objective::Plain>(RandSol, Workspace);
+
+        LargerPopulation.push_back(RandSol);
+    }
+
+    auto CompareLambda = [&](const SolutionType& s1, const SolutionType& s2) {
+        return SumConstraintViolations(s1) < SumConstraintViolations(s2);
+    };
+
+    sort(LargerPopulation.begin(), LargerPopulation.end(), CompareLambda);
+    LargerPopulation.resize(PopulationSize);
+
+    Population.clear();
+    for (const auto& Sol : LargerPopulation)
+        Population.insert(Sol);
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+int LPRSearch<Color, Total>::SumConstraintViolations(const SolutionType& Solution)
+{
+    if (Solution.size() == 0)
+        return INT_MAX;
+
+    int Sum = 0;
+    for (size_t Edge = 0; Edge < EdgeFrom.size(); ++Edge)
+        Sum = Sum + std::max(0, EdgeWeight[Edge] - std::abs(Solution[EdgeFrom[Edge]] - Solution[EdgeTo[Edge]]));
+
+    return Sum;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+int LPRSearch<Color, Total>::AugmentedSumConstraintViolations(const SolutionType& Solution)
+{
+    if (Solution.size() == 0)
+        return INT_MAX;
+
+    SyncPenalties();
+    int Sum = SumConstraintViolations(Solution);
+    for (size_t Edge = 0; Edge < EdgeFrom.size(); ++Edge)
+    {
+        if (std::abs(Solution[EdgeFrom[Edge]] - Solution[EdgeTo[Edge]]) < EdgeWeight[Edge])
+        {
+            Sum = Sum + EdgePenalty[Edge];
+        }
+    }
+    return Sum;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+int LPRSearch<Color, Total>::DistanceHamming(const SolutionType& Solution)
+{
+
+    int MinCount = INT_MAX;
+    for (const auto& CurrSol : Population)
+    {
+        int Count = 0;
+        for (int Index = 0; Index < Solution.size(); ++Index)
+            if (CurrSol[Index] != Solution[Index])
+                ++Count;
+
+        MinCount = std::min(MinCount, Count);
+    }
+
+    return MinCount;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+typename LPRSearch<Color, Total>::SolutionType LPRSearch<Color, Total>::GenerateRandomSolution()
+{
+    std::uniform_int_distribution<int> dist(1, NoColors);
+
+    SolutionType Solution;
+    Solution.resize(NoNodes);
+
+    for (int node = 0; node < NoNodes; ++node)
+    {
+        Solution[node] = (Color)dist(Gen);
+    }
+
+    return Solution;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::MixedPathRelinking(const SolutionType& FirstParent, const SolutionType& SecondParent, WorkspaceType& Work, SolutionType& Child)
+{
+    LPR_TIME(RelinkingSeconds);
+    std::vector<int>& DiffPos = Work.DiffPos;
+    SolutionType& Last = Work.Last;
+    SolutionType& PrevLast = Work.PrevLast;
+    DiffPos.clear();
+    for (int Index = 0; Index < NoNodes; ++Index)
+        if (FirstParent[Index] != SecondParent[Index])
+            DiffPos.push_back(Index);
+
+    int DiffPosLen = DiffPos.size();
+    int SumConstraintsLast, SumConstraintsPrevLast, TempSum;
+
+    PrevLast = FirstParent;
+    Last = SecondParent;
+    SumConstraintsPrevLast = SumConstraintViolations(PrevLast);
+    SumConstraintsLast = SumConstraintViolations(Last);
+
+    int CurrentLen = 2;
+    while (DiffPos.size() > 0)
+    {
+        LPR_COUNT(RelinkingSteps, 1);
+        const SolutionType* CurrentChoice;
+        if (CurrentLen % 2 == 0)
+            CurrentChoice = &SecondParent;
+        else
+            CurrentChoice = &FirstParent;
+
+        int BestSubstitutionCost = INT_MAX;
+        int BestSubstitutionIndex = INT_MAX;
+
+        for (int Index = 0; Index < DiffPos.size(); ++Index)
+        {
+            int CurrentDiffNode = DiffPos[Index];
+            int AuxSum = SumConstraintsPrevLast;
+            for (int It = AdjOffsets[CurrentDiffNode]; It < AdjOffsets[CurrentDiffNode + 1]; ++It)
+            {
+                int Neighbour = AdjNodes[It];
+                AuxSum = AuxSum - std::max(0, AdjWeights[It] - std::abs(PrevLast[CurrentDiffNode] - PrevLast[Neighbour]))
+                        + std::max(0, AdjWeights[It] - std::abs((*CurrentChoice)[CurrentDiffNode] - (*CurrentChoice)[Neighbour]));
+            }
+
+            if (AuxSum < BestSubstitutionCost)
+            {
+                BestSubstitutionCost = AuxSum;
+                BestSubstitutionIndex = Index;
+            }
+        }
+        
+        // The new Last is the old PrevLast with one more node taken from the current parent.
+        std::swap(PrevLast, Last);
+        Last[DiffPos[BestSubstitutionIndex]] = (*CurrentChoice)[DiffPos[BestSubstitutionIndex]];
+
+        TempSum = BestSubstitutionCost;
+        SumConstraintsPrevLast = SumConstraintsLast;
+        SumConstraintsLast = TempSum;
+
+        DiffPos.erase(DiffPos.begin() + BestSubstitutionIndex);
+        ++CurrentLen;
+    }
+    Child = Last;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+template <Objective Mode>
+void LPRSearch<Color, Total>::TabuSearchImpr(SolutionType& Solution, WorkspaceType& Work)
+{
+    constexpr bool IsAugmented = Mode == Objective::Augmented;
+    LPR_TIME(TabuSeconds);
+    int IntervalIteration = 0;
+    int Interval = 0;
+    int CurrentIteration = 0;
+    int CurrentDepth = 0;
+    SolutionType& BestSol = Work.BestSol;
+    BestSol = Solution;
+    std::vector<int>& TabuExpiry = Work.TabuExpiry;
+    TabuExpiry.assign((size_t)NoNodes * (NoColors + 1), -1);
+
+    int LowestConstraintViolation = SumConstraintViolations(Solution);
+    int PlainCost = LowestConstraintViolation;
+    int SolutionCost, MaxDepth;
+    if constexpr (IsAugmented)
+    {
+        SolutionCost = AugmentedSumConstraintViolations(Solution);
+        MaxDepth = Alpha0;
+    }
+    else
+    {
+        SolutionCost = SumConstraintViolations(Solution);
+        MaxDepth = Alpha;
+    }
+
+    DeltaMatrix& ColorChangeSum = Work.ColorChangeSum;
+    DeltaMatrix& ColorChangeWeightSum = Work.ColorChangeWeightSum;
+    InitializePrecalcMatrixes<Mode>(Solution, Work);
+    
+    int BestCandidateValue;
+    int BestCandidateValueTabu;
+    std::vector<std::pair<int, int>>& BestCandidateList = Work.BestCandidateList;
+    std::vector<std::pair<int, int>>& BestCandidateListTabu = Work.BestCandidateListTabu;
+    std::pair<int, int> CurrChoice;
+    std::pair<int, int> BestCandidate;
+    std::vector<int>& Candidates = Work.Candidates;
+    std::vector<int>& GapColors = Work.GapColors;
+
+    auto EvaluateMove = [&](int Node, int NewColor)
+    {
+        if (Solution[Node] == NewColor)
+            return;
+
+        CurrChoice = { Node, NewColor };
+        bool IsTabu = TabuExpiry[(size_t)Node * (NoColors + 1) + NewColor] > CurrentIteration;
+
+        int Delta = ColorChangeSum[Node][Solution[Node]] - ColorChangeSum[Node][NewColor];
+        if constexpr (IsAugmented)
+            Delta += ColorChangeWeightSum[Node][Solution[Node]] - ColorChangeWeightSum[Node][NewColor];
+
+        if (!IsTabu)
+        {
+            if (SolutionCost - Delta < BestCandidateValue)
+            {
+                BestCandidateValue = SolutionCost - Delta;
+                BestCandidateList.clear();
+                BestCandidateList.push_back(CurrChoice);
+            }
+            else if (SolutionCost - Delta == BestCandidateValue && BestCandidateList.size() < NoRandCandidates)
+            {
+                BestCandidateList.push_back(CurrChoice);
+            }
+        }
+        else
+        {
+            if (SolutionCost - Delta < BestCandidateValueTabu)
+            {
+                BestCandidateValueTabu = SolutionCost - Delta;
+                BestCandidateListTabu.clear();
+                BestCandidateListTabu.push_back(CurrChoice);
+            }
+            else if (SolutionCost - Delta == BestCandidateValueTabu && BestCandidateListTabu.size() < NoRandCandidates)
+            {
+                BestCandidateListTabu.push_back(CurrChoice);
+            }
+        }
+    };
+
+    while (CurrentDepth < MaxDepth)
+    {
+        if (LowestConstraintViolation == 0 || (CurrentIteration % 64 == 0 && TimeExpired()))
+        {
+            Solution = BestSol;
+            return;
+        }
+        if (VerifyDue(CurrentIteration))
+            VerifyIncrementalState<Mode>(Solution, SolutionCost, Work);
+
+        LPR_COUNT(TabuIterations, 1);
+        BestCandidateValue = INT_MAX;
+        BestCandidateValueTabu = INT_MAX;
+
+        BestCandidateList.clear();
+        BestCandidateListTabu.clear();
+
+        // Only conflicting nodes can lower the cost. They are scanned in node order so the
+        // capped candidate lists, and hence the random choice, do not depend on the set order.
+        Candidates.assign(Work.ConflictNodes.begin(), Work.ConflictNodes.end());
+        std::sort(Candidates.begin(), Candidates.end());
+        for (int Node : Candidates)
+        {
+            if (ExactNeighbourhood)
+            {
+                LPR_COUNT(CandidateMoves, NoColors - 1);
+                for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+                    EvaluateMove(Node, NewColor);
+            }
+            else
+            {
+                CollectGapColors(Solution, Node, Work);
+                LPR_COUNT(CandidateMoves, GapColors.size());
+                for (int NewColor : GapColors)
+                    EvaluateMove(Node, NewColor);
+            }
+        }
+
+        if (BestCandidateList.size() == 0 && BestCandidateListTabu.size() == 0)
+        {
+            Solution = BestSol;
+            return;
+        }
+
+        if (BestCandidateList.size() == 0 || BestCandidateValueTabu < std::min(BestCandidateValue, LowestConstraintViolation))
+        {
+            //Aspiration
+            LPR_COUNT(AspirationHits, 1);
+            BestCandidate = BestCandidateListTabu[Gen() % BestCandidateListTabu.size()];
+            BestCandidateValue = BestCandidateValueTabu;
+        }
+        else
+        {
+            BestCandidate = BestCandidateList[Gen() % BestCandidateList.size()];
+        }
+
+        TabuExpiry[(size_t)BestCandidate.first * (NoColors + 1) + BestCandidate.second] = CurrentIteration + TabuTenure[Interval] + Gen() % 3;
+        ++IntervalIteration;
+        if (IntervalIteration > TabuTenureInterval[Interval])
+        {
+            Interval = (Interval + 1) % Pmax;
+            IntervalIteration = 0;
+        }
+
+        ++TabuIterations;
+        if (Trace != nullptr)
+        {
+            // best_cost is the plain cost in every phase; BestCandidateValue is augmented in
+            // the augmented phase and only local to this tabu run.
+            PlainCost -= ColorChangeSum[BestCandidate.first][Solution[BestCandidate.first]] - ColorChangeSum[BestCandidate.first][BestCandidate.second];
+            bool Improved = PlainCost < TraceBestCost;
+            TraceBestCost = std::min(TraceBestCost, PlainCost);
+            Trace->Record(TabuIterations, PlainCost, TraceBestCost, BestCandidateValue,
+                IsAugmented ? TracePhase::Augmented : TracePhase::Plain, Improved);
+        }
+
+        SolutionCost = BestCandidateValue;
+        UpdatePrecalcMatrixes<Mode>(Solution, BestCandidate, Work);
+        Solution[BestCandidate.first] = (Color)BestCandidate.second;
+
+
+        if (BestCandidateValue < LowestConstraintViolation)
+        {
+            LowestConstraintViolation = BestCandidateValue;
+            BestSol = Solution;
+            CurrentDepth = 0;
+        }
+        else
+        {
+            ++CurrentDepth;
+        }
+
+        ++CurrentIteration;
+    }
+
+    Solution = BestSol;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::TwoPhaseTabuSearch(SolutionType& Solution)
+{
+    TabuSearchImpr<Objective::Augmented>(Solution, Workspace);
+    TabuSearchImpr<Objective::Plain>(Solution, Workspace);
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::Improvement_and_Updating(SolutionType& CurrentSol, SolutionType& BestSol, PairSetType& PairSet)
+{
+    TwoPhaseTabuSearch(CurrentSol);
+    UpdatePenaltyMatrix(CurrentSol);   
+    
+    if (SumConstraintViolations(CurrentSol) < SumConstraintViolations(BestSol))
+        BestSol = CurrentSol;
+    
+    int MaxConstraintViolation = 0;
+    SolutionType WorstSol;
+    for (const auto& Sol : Population)
+    {
+        int Sum = SumConstraintViolations(Sol);
+        if (Sum > MaxConstraintViolation)
+        {
+            MaxConstraintViolation = Sum;
+            WorstSol = Sol;
+        }
+    }
+
+    if (SumConstraintViolations(CurrentSol) < SumConstraintViolations(WorstSol) &&
+        DistanceHamming(CurrentSol) > 0.1f * NoNodes)
+    {
+        LPR_COUNT(PopulationReplacements, 1);
+        Population.insert(CurrentSol);
+        Population.erase(WorstSol);
+        for (const auto& KSol : Population)
+        {
+            if (PairSet.find({ WorstSol, KSol }) != PairSet.end())
+            {
+                PairSet.erase({ WorstSol, KSol });
+                PairSet.insert({ CurrentSol, KSol });
+            }
+
+            if (PairSet.find({ KSol, WorstSol }) != PairSet.end())
+            {
+                PairSet.erase({ KSol, WorstSol });
+                PairSet.insert({ KSol, CurrentSol });
+            }
+
+        }
+
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::UpdatePenaltyMatrix(const SolutionType& Solution)
+{
+    // Only violated edges are written. A rescale bumps the epoch instead of touching
+    // every edge; floor(s * p) is monotone, so the maximum can be rescaled in place.
+    LPR_TIME(PenaltySeconds);
+    for (size_t Edge = 0; Edge < EdgeFrom.size(); ++Edge)
+    {
+        if (std::abs(Solution[EdgeFrom[Edge]] - Solution[EdgeTo[Edge]]) < EdgeWeight[Edge])
+        {
+            int Penalty = RescaledPenalty(EdgePenalty[Edge], PenaltyEpoch - EdgeEpoch[Edge]) + 1;
+            EdgePenalty[Edge] = (Total)Penalty;
+            EdgeEpoch[Edge] = PenaltyEpoch;
+            MaxPenalty = std::max(MaxPenalty, Penalty);
+        }
+    }
+
+    if (MaxPenalty > MaxPenaltyWeight)
+    {
+        LPR_COUNT(PenaltyRescales, 1);
+        ++PenaltyEpoch;
+        MaxPenalty = RescaledPenalty(MaxPenalty, 1);
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+int LPRSearch<Color, Total>::RescaledPenalty(int Penalty, int Rescales) const
+{
+    for (; Rescales > 0 && Penalty > 0; --Rescales)
+        Penalty = (int)std::floor(ScalingFactor * Penalty);
+    return Penalty;
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::SyncPenalties()
+{
+    for (size_t Edge = 0; Edge < EdgeFrom.size(); ++Edge)
+    {
+        if (EdgeEpoch[Edge] != PenaltyEpoch)
+        {
+            EdgePenalty[Edge] = (Total)RescaledPenalty(EdgePenalty[Edge], PenaltyEpoch - EdgeEpoch[Edge]);
+            EdgeEpoch[Edge] = PenaltyEpoch;
+        }
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+template <Objective Mode>
+void LPRSearch<Color, Total>::InitializePrecalcMatrixes(const SolutionType& Solution, WorkspaceType& Work)
+{
+    DeltaMatrix& ColorChangeSum = Work.ColorChangeSum;
+    DeltaMatrix& ColorChangeWeightSum = Work.ColorChangeWeightSum;
+    Work.ConflictDegree.assign(NoNodes, 0);
+    Work.ConflictIndex.assign(NoNodes, -1);
+    Work.ConflictNodes.clear();
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        int Degree = 0;
+        for (int It = AdjOffsets[Node]; It < AdjOffsets[Node + 1]; ++It)
+        {
+            if (std::abs(Solution[Node] - Solution[AdjNodes[It]]) < AdjWeights[It])
+                ++Degree;
+        }
+        AdjustConflictDegree(Work, Node, Degree);
+    }
+
+    ColorChangeSum.resize(NoNodes);
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        ColorChangeSum[Node].resize(NoColors + 1);
+        for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+        {
+            ColorChangeSum[Node][NewColor] = 0;
+            for (int It = AdjOffsets[Node]; It < AdjOffsets[Node + 1]; ++It)
+            {
+                ColorChangeSum[Node][NewColor] += std::max(0, AdjWeights[It] - std::abs(Solution[AdjNodes[It]] - NewColor));
+            }
+        }
+    }
+
+    if constexpr (Mode == Objective::Augmented)
+    {
+        SyncPenalties();
+        ColorChangeWeightSum.resize(NoNodes);
+        for (int Node = 0; Node < NoNodes; ++Node)
+        {
+            ColorChangeWeightSum[Node].resize(NoColors + 1);
+            for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+            {
+                ColorChangeWeightSum[Node][NewColor] = 0;
+                for (int It = AdjOffsets[Node]; It < AdjOffsets[Node + 1]; ++It)
+                {
+                    if(std::abs(Solution[AdjNodes[It]] - NewColor) < AdjWeights[It])
+                        ColorChangeWeightSum[Node][NewColor] += EdgePenalty[AdjEdge[It]];
+                }
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+template <Objective Mode>
+void LPRSearch<Color, Total>::UpdatePrecalcMatrixes(const SolutionType& Solution, std::pair<int, int> BestCandidate, WorkspaceType& Work)
+{
+    DeltaMatrix& ColorChangeSum = Work.ColorChangeSum;
+    DeltaMatrix& ColorChangeWeightSum = Work.ColorChangeWeightSum;
+    LPR_COUNT(PrecalcUpdates, 1);
+    int Start, End;
+    int OldColor = Solution[BestCandidate.first];
+    for (int It = AdjOffsets[BestCandidate.first]; It < AdjOffsets[BestCandidate.first + 1]; ++It)
+    {
+        int Neighbour = AdjNodes[It];
+        int Weight = AdjWeights[It];
+        if (Neighbour != BestCandidate.first)
+        {
+            int Change = (std::abs(BestCandidate.second - Solution[Neighbour]) < Weight) - (std::abs(OldColor - Solution[Neighbour]) < Weight);
+            if (Change != 0)
+            {
+                AdjustConflictDegree(Work, BestCandidate.first, Change);
+                AdjustConflictDegree(Work, Neighbour, Change);
+            }
+        }
+
+        Start = std::max(1, OldColor - Weight + 1);
+        End = std::min(NoColors, OldColor + Weight - 1);
+        for (int NewColor = Start; NewColor <= End; ++NewColor)
+        {
+            ColorChangeSum[Neighbour][NewColor] -= (Weight - std::abs(OldColor - NewColor));
+        }
+
+        Start = std::max(1, BestCandidate.second - Weight + 1);
+        End = std::min(NoColors, BestCandidate.second + Weight - 1);
+
+        for (int NewColor = Start; NewColor <= End; ++NewColor)
+        {
+            ColorChangeSum[Neighbour][NewColor] += (Weight - std::abs(BestCandidate.second - NewColor));
+        }
+
+    }
+
+    if constexpr (Mode == Objective::Augmented)
+    {
+        for (int It = AdjOffsets[BestCandidate.first]; It < AdjOffsets[BestCandidate.first + 1]; ++It)
+        {
+            int Neighbour = AdjNodes[It];
+            int Weight = AdjWeights[It];
+            Total Penalty = EdgePenalty[AdjEdge[It]];
+            Start = std::max(1, OldColor - Weight + 1);
+            End = std::min(NoColors, OldColor + Weight - 1);
+            for (int NewColor = Start; NewColor <= End; ++NewColor)
+            {
+                ColorChangeWeightSum[Neighbour][NewColor] -= Penalty;
+            }
+
+            Start = std::max(1, BestCandidate.second - Weight + 1);
+            End = std::min(NoColors, BestCandidate.second + Weight - 1);
+
+            for (int NewColor = Start; NewColor <= End; ++NewColor)
+            {
+                ColorChangeWeightSum[Neighbour][NewColor] += Penalty;
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+template <Objective Mode>
+void LPRSearch<Color, Total>::VerifyIncrementalState(const SolutionType& Solution, int SolutionCost, WorkspaceType& Work)
+{
+    auto Check = [&](bool Condition, const char* What, int Node, int AtColor)
+    {
+        if (Condition)
+            return;
+        std::cerr << "LPR incremental state mismatch: " << What << " (node " << Node << ", color " << AtColor << ")\n";
+        std::abort();
+    };
+
+    int Cost = Mode == Objective::Augmented ? AugmentedSumConstraintViolations(Solution) : SumConstraintViolations(Solution);
+    Check(Cost == SolutionCost, "solution cost", -1, -1);
+
+    for (int Node = 0; Node < NoNodes; ++Node)
+    {
+        int Degree = 0;
+        for (int It = AdjOffsets[Node]; It < AdjOffsets[Node + 1]; ++It)
+        {
+            if (std::abs(Solution[Node] - Solution[AdjNodes[It]]) < AdjWeights[It])
+                ++Degree;
+        }
+        Check(Work.ConflictDegree[Node] == Degree, "conflict degree", Node, -1);
+        bool InSet = Work.ConflictIndex[Node] >= 0 && Work.ConflictIndex[Node] < (int)Work.ConflictNodes.size() && Work.ConflictNodes[Work.ConflictIndex[Node]] == Node;
+        Check(InSet == (Degree > 0), "conflict set", Node, -1);
+
+        for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+        {
+            int Sum = 0;
+            int WeightSum = 0;
+            for (int It = AdjOffsets[Node]; It < AdjOffsets[Node + 1]; ++It)
+            {
+                Sum += std::max(0, AdjWeights[It] - std::abs(Solution[AdjNodes[It]] - NewColor));
+                if (std::abs(Solution[AdjNodes[It]] - NewColor) < AdjWeights[It])
+                    WeightSum += EdgePenalty[AdjEdge[It]];
+            }
+            Check(Work.ColorChangeSum[Node][NewColor] == Sum, "ColorChangeSum", Node, NewColor);
+            if constexpr (Mode == Objective::Augmented)
+                Check(Work.ColorChangeWeightSum[Node][NewColor] == WeightSum, "ColorChangeWeightSum", Node, NewColor);
+        }
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::AdjustConflictDegree(WorkspaceType& Work, int Node, int Change)
+{
+    std::vector<int>& ConflictDegree = Work.ConflictDegree;
+    std::vector<int>& ConflictNodes = Work.ConflictNodes;
+    std::vector<int>& ConflictIndex = Work.ConflictIndex;
+    bool WasConflicting = ConflictDegree[Node] > 0;
+    ConflictDegree[Node] += Change;
+    bool IsConflicting = ConflictDegree[Node] > 0;
+    if (IsConflicting && !WasConflicting)
+    {
+        ConflictIndex[Node] = (int)ConflictNodes.size();
+        ConflictNodes.push_back(Node);
+    }
+    else if (WasConflicting && !IsConflicting)
+    {
+        int Last = ConflictNodes.back();
+        ConflictNodes[ConflictIndex[Node]] = Last;
+        ConflictIndex[Last] = ConflictIndex[Node];
+        ConflictNodes.pop_back();
+        ConflictIndex[Node] = -1;
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+void LPRSearch<Color, Total>::CollectGapColors(const SolutionType& Solution, int Node, WorkspaceType& Work)
+{
+    std::vector<int>& Colors = Work.GapColors;
+    std::vector<std::pair<int, int>>& Windows = Work.Windows;
+    // Any color outside all neighbour windows clears the node, so the ends of the gaps
+    // between the merged windows are enough. A node without a gap falls back to the
+    // window edges, where its deltas have their local minima, and a node with more
+    // window edges than colors to the whole range.
+    Colors.clear();
+    if (2 * (AdjOffsets[Node + 1] - AdjOffsets[Node]) + 2 >= NoColors)
+    {
+        for (int NewColor = 1; NewColor <= NoColors; ++NewColor)
+            Colors.push_back(NewColor);
+        return;
+    }
+
+    Windows.clear();
+    for (int It = AdjOffsets[Node]; It < AdjOffsets[Node + 1]; ++It)
+        Windows.push_back({ Solution[AdjNodes[It]] - AdjWeights[It] + 1, Solution[AdjNodes[It]] + AdjWeights[It] - 1 });
+    std::sort(Windows.begin(), Windows.end());
+
+    int Next = 1;
+    for (const auto& Window : Windows)
+    {
+        if (Window.first > NoColors)
+            break;
+        if (Window.first > Next)
+        {
+            Colors.push_back(Next);
+            if (Window.first - 1 > Next)
+                Colors.push_back(Window.first - 1);
+        }
+        Next = std::max(Next, Window.second + 1);
+    }
+    if (Next <= NoColors)
+    {
+        Colors.push_back(Next);
+        if (NoColors > Next)
+            Colors.push_back(NoColors);
+    }
+
+    if (Colors.empty())
+    {
+        Colors.assign({ 1, NoColors });
+        for (const auto& Window : Windows)
+        {
+            if (Window.first - 1 >= 1)
+                Colors.push_back(Window.first - 1);
+            if (Window.second + 1 <= NoColors)
+                Colors.push_back(Window.second + 1);
+        }
+        std::sort(Colors.begin(), Colors.end());
+        Colors.erase(std::unique(Colors.begin(), Colors.end()), Colors.end());
+    }
+
+    for (int Sample = 0; Sample < GapSamples; ++Sample)
+    {
+        int NewColor = 1 + Gen() % NoColors;
+        if (std::find(Colors.begin(), Colors.end(), NewColor) == Colors.end())
+            Colors.push_back(NewColor);
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+template <typename Color, typename Total>
+const char* LPRSearch<Color, Total>::Layout() const
+{
+    if constexpr (sizeof(Color) == 1)
+        return sizeof(Total) == 2 ? "u8/i16" : "u8/i32";
+    else if constexpr (sizeof(Color) == 2)
+        return sizeof(Total) == 2 ? "u16/i16" : "u16/i32";
+    else
+        return "i32/i32";
+}
+//------------------------------------------------------------------------------------------------
+
+std::unique_ptr<LPRSearchBase> LPR::CreateSearch(int NoNodes, int NoEdges, int NoColors, const std::vector<std::vector<int>>& Edges, const LPRParameters& Parameters, unsigned Seed)
+{
+    // A delta sum adds at most one weight and one penalty per neighbour; penalties stay
+    // at most MaxPenaltyWeight + 1 since Validate keeps the rescaling factor below 1.
+    int MaxWeight = 0;
+    int MaxDegree = 0;
+    for (const auto& Line : Edges)
+    {
+        int Degree = 0;
+        for (int Weight : Line)
+        {
+            MaxWeight = std::max(MaxWeight, Weight);
+            Degree += Weight > 0;
+        }
+        MaxDegree = std::max(MaxDegree, Degree);
+    }
+
+    int MaxColor = std::max(NoColors, MaxWeight);
+    bool NarrowSums = (int64_t)MaxDegree * (MaxWeight + Parameters.MaxPenaltyWeight + 1) <= INT16_MAX;
+
+    if (MaxColor <= UINT8_MAX && NarrowSums)
+        return std::make_unique<LPRSearch<uint8_t, int16_t>>(NoNodes, NoEdges, NoColors, Edges, Parameters, Seed);
+    else if (MaxColor <= UINT8_MAX)
+        return std::make_unique<LPRSearch<uint8_t, int32_t>>(NoNodes, NoEdges, NoColors, Edges, Parameters, Seed);
+    else if (MaxColor <= UINT16_MAX && NarrowSums)
+        return std::make_unique<LPRSearch<uint16_t, int16_t>>(NoNodes, NoEdges, NoColors, Edges, Parameters, Seed);
+    else if (MaxColor <= UINT16_MAX)
+        return std::make_unique<LPRSearch<uint16_t, int32_t>>(NoNodes, NoEdges, NoColors, Edges, Parameters, Seed);
+    else
+        return std::make_unique<LPRSearch<int32_t, int32_t>>(NoNodes, NoEdges, NoColors, Edges, Parameters, Seed);
+}
+//------------------------------------------------------------------------------------------------
+
+LPR::LPR(int NoNodes, int NoEdges, int NoColors, std::vector<std::vector<int>> Edges, const LPRParameters& Parameters, unsigned Seed)
+    : NoColors(NoColors), FixedColors(NoNodes, 0)
+{
+    Parameters.Validate();
+
+    // Peeled nodes are colored after the search, the rest of the graph forms the kernel.
+    GraphComponent Kernel;
+    if (Parameters.PeelLowDegree)
+        Peeled = GraphReduction::PeelLowDegree(Edges, NoColors);
+    if (Peeled.empty())
+    {
+        Kernel.Nodes.resize(NoNodes);
+        std::iota(Kernel.Nodes.begin(), Kernel.Nodes.end(), 0);
+        Kernel.NoEdges = NoEdges;
+        Kernel.Edges = std::move(Edges);
+    }
+    else
+    {
+        std::vector<char> IsPeeled(NoNodes, 0);
+        for (const auto& Node : Peeled)
+            IsPeeled[Node.Node] = 1;
+        std::vector<int> KernelNodes;
+        for (int Node = 0; Node < NoNodes; ++Node)
+        {
+            if (!IsPeeled[Node])
+                KernelNodes.push_back(Node);
+        }
+        Kernel = GraphReduction::Induce(Edges, std::move(KernelNodes));
+    }
+
+    std::vector<GraphComponent> Components;
+    if (Parameters.SplitComponents)
+    {
+        Components = GraphReduction::SplitComponents(std::move(Kernel.Edges));
+        for (auto& Component : Components)
+        {
+            for (auto& Node : Component.Nodes)
+                Node = Kernel.Nodes[Node];
+        }
+        std::stable_sort(Components.begin(), Components.end(),
+            [](const GraphComponent& First, const GraphComponent& Second) { return First.Nodes.size() > Second.Nodes.size(); });
+    }
+    else if (!Kernel.Nodes.empty())
+        Components.push_back(std::move(Kernel));
+
+    for (auto& Component : Components)
+    {
+        int Size = Component.Nodes.size();
+        if (Size <= 2)
+        {
+            // An isolated node takes color 1, the ends of a single edge colors 1 and 1 + w;
+            // a self loop can never be satisfied.
+            int Weight = Size == 2 ? Component.Edges[0][1] : 0;
+            for (int Index = 0; Index < Size; ++Index)
+                FixedFeasible = FixedFeasible && Component.Edges[Index][Index] == 0;
+            FixedFeasible = FixedFeasible && 1 + Weight <= NoColors;
+            FixedColors[Component.Nodes[0]] = 1;
+            if (Size == 2)
+                FixedColors[Component.Nodes[1]] = std::min(1 + Weight, NoColors);
+            continue;
+        }
+
+        if (Parameters.ReorderNodes)
+        {
+            GraphComponent Reordered = GraphReduction::Induce(Component.Edges, GraphReduction::ReverseCuthillMcKee(Component.Edges));
+            for (auto& Node : Reordered.Nodes)
+                Node = Component.Nodes[Node];
+            Component = std::move(Reordered);
+        }
+
+        // The largest component keeps the seed, so a connected instance runs exactly as
+        // without the split. A small component cannot fill a larger population.
+        unsigned PartSeed = Seed + 0x9E3779B9u * (unsigned)Parts.size();
+        LPRParameters PartParameters = Parameters;
+        PartParameters.PopulationSize = std::min(Parameters.PopulationSize, Size);
+        Parts.push_back({ std::move(Component.Nodes), CreateSearch(Size, Component.NoEdges, NoColors, Component.Edges, PartParameters, PartSeed) });
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+std::vector<int> LPR::Solve()
+{
+    auto Start = std::chrono::steady_clock::now();
+    if (!FixedFeasible)
+        return std::vector<int>();
+
+    std::vector<std::vector<int>> Solutions(Parts.size());
+    auto SolvePart = [&](int Index) { Solutions[Index] = Parts[Index].Search->Solve(Start); };
+    if (Pool != nullptr && Parts.size() > 1)
+        Pool->ParallelFor(Parts.size(), SolvePart);
+    else
+    {
+        for (int Index = 0; Index < (int)Parts.size(); ++Index)
+            SolvePart(Index);
+    }
+
+    Counters = LPRCounters();
+    for (const auto& Part : Parts)
+        Counters += Part.Search->GetCounters();
+
+    std::vector<int> Solution = FixedColors;
+    for (int Index = 0; Index < (int)Parts.size(); ++Index)
+    {
+        if (Solutions[Index].empty())
+            return std::vector<int>();
+        for (int Node = 0; Node < (int)Parts[Index].Nodes.size(); ++Node)
+            Solution[Parts[Index].Nodes[Node]] = Solutions[Index][Node];
+    }
+    GraphReduction::ColorPeeled(Peeled, NoColors, Solution);
+    return Solution;
+}
+//------------------------------------------------------------------------------------------------
+
+int64_t LPR::GetTabuIterations() const
+{
+    int64_t Iterations = 0;
+    for (const auto& Part : Parts)
+        Iterations += Part.Search->GetTabuIterations();
+    return Iterations;
+}
+//------------------------------------------------------------------------------------------------
+
+void LPR::SetTrace(ConvergenceTrace* Trace)
+{
+    if (!Parts.empty())
+        Parts[0].Search->SetTrace(Trace);
+}
+//------------------------------------------------------------------------------------------------
+
+const char* LPR::Layout() const
+{
+    return Parts.empty() ? "closed form" : Parts[0].Search->Layout();
+}
+//------------------------------------------------------------------------------------------------
+
+#define LPR_INSTANTIATE(Color, Total) \
+    template class LPRSearch<Color, Total>; \
+    template void LPRSearch<Color, Total>::TabuSearchImpr<Objective::Plain>(SolutionType&, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::TabuSearchImpr<Objective::Augmented>(SolutionType&, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::InitializePrecalcMatrixes<Objective::Plain>(const SolutionType&, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::InitializePrecalcMatrixes<Objective::Augmented>(const SolutionType&, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::UpdatePrecalcMatrixes<Objective::Plain>(const SolutionType&, std::pair<int, int>, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::UpdatePrecalcMatrixes<Objective::Augmented>(const SolutionType&, std::pair<int, int>, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::VerifyIncrementalState<Objective::Plain>(const SolutionType&, int, WorkspaceType&); \
+    template void LPRSearch<Color, Total>::VerifyIncrementalState<Objective::Augmented>(const SolutionType&, int, WorkspaceType&);
+
+LPR_INSTANTIATE(uint8_t, int16_t)
+LPR_INSTANTIATE(uint8_t, int32_t)
+LPR_INSTANTIATE(uint16_t, int16_t)
+LPR_INSTANTIATE(uint16_t, int32_t)
+LPR_INSTANTIATE(int32_t, int32_t)
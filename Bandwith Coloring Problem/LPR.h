@@ -1,56 +1,52 @@
-#pragma once
-#include <iostream>
-#include <vector>
-#include <set>
-#include <random>
-#include <queue>
-#include <functional>
-#include <chrono>
-#include <map>
-#include <limits.h>
-
-#include <cassert>
-
-
-class LPR
-{
-private:
-    int NoNodes;
-    int NoEdges;
-    int NoColors;
-    int PopulationSize;
-    int Alpha;
-    int Alpha0;
-    int Tmax;
-    int MaxPenaltyWeight;
-    int Pmax;
-    float ScalingFactor;
-    std::vector<int> TabuTenure;
-    std::vector<int> TabuTenureInterval;
-    std::vector<std::vector<int>> Edges;
-    std::vector<std::vector<int>> AdjList;
-    std::vector<std::vector<int>> PenaltyMatrix;
-    std::set<std::vector<int>> Population;
-
-public:
-    LPR(int Nodes, int NoEdges, int NoColors, int PopulationSize, std::vector<std::vector<int>> Edges);
-
-    std::vector<int> Solve();
-
-private:
-    void InitializeVariables();
-    void InitializePopulation();
-    void TabuSearchImpr(std::vector<int>& Solution, bool IsAugmented);
-    void TabuSearch(std::vector<int>& Solution, bool IsAugmented);
-    void TwoPhaseTabuSearch(std::vector<int>& Solution);
-    void Improvement_and_Updating(std::vector<int>& CurrentSol, std::vector<int>& BestSol, std::set<std::pair<std::vector<int>, std::vector<int>>>& PairSet);
-    void UpdatePenaltyMatrix(std::vector<int> Solution);
-    void InitializePrecalcMatrixes(std::vector<int> Solution, std::vector<std::vector<int>>& ColorChangeSum, std::vector<std::vector<int>>& ColorChangeWeightSum, bool IsAugmented);
-    void UpdatePrecalcMatrixes(std::vector<int> Solution, std::pair<int, int> BestCandidate, std::vector<std::vector<int>>& ColorChangeSum, std::vector<std::vector<int>>& ColorChangeWeightSum, bool IsAugmented);
-    int SumConstraintViolations(std::vector<int> Solution);
-    int AugmentedSumConstraintViolations(std::vector<int> Solution);
-    int DistanceHamming(std::vector<int> Solution);
-    std::vector<int> GenerateRandomSolution();
-    std::vector<int> MixedPathRelinking(std::vector<int> FirstParent, std::vector<int> SecondParent);
-};
-
+#pragma once
+#include <vector>
+#include <memory>
+#include <random>
+#include <numeric>
+
+#include "LPRSearch.h"
+#include "GraphReduction.h"
+#include "ThreadPool.h"
+
+// Entry point of the solver. Nodes that can always be colored last are peeled off
+// first and colored greedily once the rest is solved. The rest is split into connected
+// components that are solved independently and stitched back together; isolated nodes
+// and single edges are colored in closed form, every other component gets its own search,
+// optionally on its nodes renumbered for locality. Part::Nodes maps the ids of a search
+// back to the instance.
+// The storage layout of a search is chosen from its component: colors and weights in
+// bytes when K and the largest weight fit, delta sums in 16 bits when no node can
+// accumulate more than INT16_MAX.
+class LPR
+{
+    struct Part
+    {
+        std::vector<int> Nodes;
+        std::unique_ptr<LPRSearchBase> Search;
+    };
+
+    int NoColors;
+    std::vector<Part> Parts;
+    std::vector<PeeledNode> Peeled;
+    // Colors of the closed-form nodes, 0 for nodes left to a search.
+    std::vector<int> FixedColors;
+    bool FixedFeasible = true;
+    ThreadPool* Pool = nullptr;
+    LPRCounters Counters;
+
+    static std::unique_ptr<LPRSearchBase> CreateSearch(int NoNodes, int NoEdges, int NoColors, const std::vector<std::vector<int>>& Edges, const LPRParameters& Parameters, unsigned Seed);
+
+public:
+    LPR(int Nodes, int NoEdges, int NoColors, std::vector<std::vector<int>> Edges, const LPRParameters& Parameters = {}, unsigned Seed = std::random_device()());
+
+    // An empty result means that some component was not solved.
+    std::vector<int> Solve();
+    const LPRCounters& GetCounters() const { return Counters; }
+    int64_t GetTabuIterations() const;
+    // The trace follows the search of the largest component.
+    void SetTrace(ConvergenceTrace* Trace);
+    // Components are solved in parallel on Pool when one is set, Solve may run inside one of its tasks.
+    void SetPool(ThreadPool* Pool) { this->Pool = Pool; }
+    const char* Layout() const;
+    int NoSearches() const { return Parts.size(); }
+};
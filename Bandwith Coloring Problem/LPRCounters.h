@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+
+// Hot-path counters and timers of one LPR run. They are only maintained when the
+// solver is built with LPR_INSTRUMENT defined, otherwise the LPR_COUNT / LPR_TIME
+// macros expand to nothing and the struct stays zero.
+// Timers are inclusive: InitSeconds also contains the tabu searches it runs.
+struct LPRCounters
+{
+#ifdef LPR_INSTRUMENT
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    long long TabuIterations = 0;
+    long long CandidateMoves = 0;
+    long long AspirationHits = 0;
+    long long PrecalcUpdates = 0;
+    long long PenaltyRescales = 0;
+    long long RelinkingSteps = 0;
+    long long PopulationReplacements = 0;
+    long long Restarts = 0;
+    double InitSeconds = 0;
+    double TabuSeconds = 0;
+    double RelinkingSeconds = 0;
+    double PenaltySeconds = 0;
+
+    LPRCounters& operator+=(const LPRCounters& Other)
+    {
+        TabuIterations += Other.TabuIterations;
+        CandidateMoves += Other.CandidateMoves;
+        AspirationHits += Other.AspirationHits;
+        PrecalcUpdates += Other.PrecalcUpdates;
+        PenaltyRescales += Other.PenaltyRescales;
+        RelinkingSteps += Other.RelinkingSteps;
+        PopulationReplacements += Other.PopulationReplacements;
+        Restarts += Other.Restarts;
+        InitSeconds += Other.InitSeconds;
+        TabuSeconds += Other.TabuSeconds;
+        RelinkingSeconds += Other.RelinkingSeconds;
+        PenaltySeconds += Other.PenaltySeconds;
+        return *this;
+    }
+
+    static std::string CsvHeader()
+    {
+        return "Tabu Iterations, Candidate Moves, Aspiration Hits, Precalc Updates, Penalty Rescales, "
+            "Relinking Steps, Population Replacements, Restarts, Init Time, Tabu Time, Relinking Time, Penalty Time";
+    }
+
+    std::string CsvRow() const
+    {
+        return std::to_string(TabuIterations) + ", " + std::to_string(CandidateMoves) + ", " + std::to_string(AspirationHits) + ", "
+            + std::to_string(PrecalcUpdates) + ", " + std::to_string(PenaltyRescales) + ", " + std::to_string(RelinkingSteps) + ", "
+            + std::to_string(PopulationReplacements) + ", " + std::to_string(Restarts) + ", " + std::to_string(InitSeconds) + ", "
+            + std::to_string(TabuSeconds) + ", " + std::to_string(RelinkingSeconds) + ", " + std::to_string(PenaltySeconds);
+    }
+};
+
+class LPRScopedTimer
+{
+    double& Target;
+    std::chrono::steady_clock::time_point Start;
+public:
+    explicit LPRScopedTimer(double& Target) : Target(Target), Start(std::chrono::steady_clock::now()) {}
+    ~LPRScopedTimer()
+    {
+        std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+        Target += Elapsed.count();
+    }
+};
+
+#ifdef LPR_INSTRUMENT
+#define LPR_COUNT(Counter, Amount) (Counters.Counter += (Amount))
+#define LPR_TIME(Timer) LPRScopedTimer LPRTimer_##Timer(Counters.Timer)
+#else
+#define LPR_COUNT(Counter, Amount) ((void)0)
+#define LPR_TIME(Timer) ((void)0)
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <stdexcept>
+
+// Tuning parameters of one LPR run. The defaults are the values of the original
+// implementation; TimeLimit is in seconds per run, 0 means no limit. Without
+// ExactNeighbourhood the tabu search only tries the window edges of the neighbours'
+// colors plus GapSamples random colors per conflicting node. SplitComponents solves
+// every connected component on its own, PeelLowDegree leaves the nodes that can always
+// be colored last out of the search and ReorderNodes renumbers every searched component
+// in reverse Cuthill-McKee order.
+struct LPRParameters
+{
+    int PopulationSize = 20;
+    int Alpha = 10000;
+    int Alpha0 = 2000;
+    int Tmax = 50;
+    int MaxPenaltyWeight = 30;
+    float ScalingFactor = 0.4f;
+    int NoRandCandidates = 100;
+    int MaxRestarts = 2;
+    double TimeLimit = 0;
+    bool ExactNeighbourhood = true;
+    int GapSamples = 4;
+    bool SplitComponents = true;
+    bool PeelLowDegree = true;
+    bool ReorderNodes = false;
+
+    // Throws std::invalid_argument for values the search cannot run with. With a scaling
+    // factor of 1 or more the penalties never drop back under MaxPenaltyWeight.
+    void Validate() const
+    {
+        if (!(ScalingFactor >= 0 && ScalingFactor < 1))
+            throw std::invalid_argument("the penalty scaling factor must be in [0, 1), got " + std::to_string(ScalingFactor));
+    }
+};
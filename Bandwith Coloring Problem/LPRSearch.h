@@ -0,0 +1,154 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <set>
+#include <random>
+#include <queue>
+#include <functional>
+#include <chrono>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits.h>
+
+#include <cassert>
+
+#include "LPRCounters.h"
+#include "ConvergenceTrace.h"
+#include "LPRParameters.h"
+#include "SearchWorkspace.h"
+
+// Debug builds recompute the incremental tabu search state from scratch every
+// LPR_VERIFY_INTERVAL iterations and abort on any difference, see VerifyIncrementalState.
+// 0 turns the check off; release builds default to 0.
+#ifndef LPR_VERIFY_INTERVAL
+#ifdef NDEBUG
+#define LPR_VERIFY_INTERVAL 0
+#else
+#define LPR_VERIFY_INTERVAL 256
+#endif
+#endif
+constexpr bool VerifyDue(int Iteration)
+{
+    return LPR_VERIFY_INTERVAL > 0 && Iteration % (LPR_VERIFY_INTERVAL > 0 ? LPR_VERIFY_INTERVAL : 1) == 0;
+}
+
+// Objective minimised by one tabu search. Every mode is a separate instantiation of
+// the search kernel, so the inner node x color loop carries no mode branches.
+enum class Objective
+{
+    Plain,
+    Augmented
+};
+
+// Everything of an LPR run that does not depend on the storage types: parameters,
+// tabu tenure schedule, random generator, counters and the attached trace.
+class LPRSearchBase
+{
+public:
+    virtual ~LPRSearchBase() = default;
+
+    // The time limit counts from Start, which lets several searches share one deadline.
+    virtual std::vector<int> Solve(std::chrono::steady_clock::time_point Start) = 0;
+    virtual const char* Layout() const = 0;
+    const LPRCounters& GetCounters() const { return Counters; }
+    int64_t GetTabuIterations() const { return TabuIterations; }
+    void SetTrace(ConvergenceTrace* Trace) { this->Trace = Trace; }
+
+protected:
+    int NoNodes;
+    int NoEdges;
+    int NoColors;
+    int PopulationSize;
+    int Alpha;
+    int Alpha0;
+    int Tmax;
+    int MaxPenaltyWeight;
+    int Pmax;
+    float ScalingFactor;
+    int NoRandCandidates;
+    int MaxRestarts;
+    double TimeLimit;
+    bool ExactNeighbourhood;
+    int GapSamples;
+    std::chrono::steady_clock::time_point Deadline;
+    std::vector<int> TabuTenure;
+    std::vector<int> TabuTenureInterval;
+    LPRCounters Counters;
+    ConvergenceTrace* Trace = nullptr;
+    // Lowest plain cost of the run so far, the best_cost column of the trace.
+    int TraceBestCost = INT_MAX;
+    int64_t TabuIterations = 0;
+    std::mt19937 Gen;
+
+    LPRSearchBase(int NoNodes, int NoEdges, int NoColors, const LPRParameters& Parameters, unsigned Seed);
+
+    void InitializeVariables(const LPRParameters& Parameters);
+    bool TimeExpired() const { return TimeLimit > 0 && std::chrono::steady_clock::now() >= Deadline; }
+};
+
+// The LPR memetic search on one storage layout. Color holds a color and an edge
+// weight, Total the entries of the node x color delta matrices and the penalties.
+// LPR picks the narrowest layout that fits the instance.
+template <typename Color, typename Total>
+class LPRSearch : public LPRSearchBase
+{
+    // Gives the benchmark and verification executables access to the kernels.
+    friend struct LPRKernelAccess;
+
+public:
+    using ColorType = Color;
+    using TotalType = Total;
+    using SolutionType = PooledSolution<Color>;
+    using PopulationSet = std::set<SolutionType, std::less<SolutionType>, PoolAllocator<SolutionType>>;
+    using PairSetType = std::set<std::pair<SolutionType, SolutionType>, std::less<std::pair<SolutionType, SolutionType>>, PoolAllocator<std::pair<SolutionType, SolutionType>>>;
+    using DeltaMatrix = std::vector<std::vector<Total>>;
+    using WorkspaceType = SearchWorkspace<Color, Total>;
+
+    LPRSearch(int NoNodes, int NoEdges, int NoColors, const std::vector<std::vector<int>>& Edges, const LPRParameters& Parameters, unsigned Seed);
+
+    std::vector<int> Solve(std::chrono::steady_clock::time_point Start) override;
+    const char* Layout() const override;
+
+private:
+    // Every undirected edge once, with its penalty, and the CSR adjacency of every
+    // node; AdjEdge maps both entries of an edge to its id. A penalty is stored as of
+    // EdgeEpoch and still owes the rescales up to PenaltyEpoch, see SyncPenalties.
+    std::vector<int> EdgeFrom;
+    std::vector<int> EdgeTo;
+    std::vector<Color> EdgeWeight;
+    std::vector<Total> EdgePenalty;
+    std::vector<int> EdgeEpoch;
+    int PenaltyEpoch = 0;
+    int MaxPenalty = 0;
+    std::vector<int> AdjOffsets;
+    std::vector<int> AdjNodes;
+    std::vector<Color> AdjWeights;
+    std::vector<int> AdjEdge;
+    PopulationSet Population;
+    WorkspaceType Workspace;
+
+    void InitializeAdjacency(const std::vector<std::vector<int>>& Edges);
+    void InitializePopulation();
+    template <Objective Mode>
+    void TabuSearchImpr(SolutionType& Solution, WorkspaceType& Work);
+    void TwoPhaseTabuSearch(SolutionType& Solution);
+    void Improvement_and_Updating(SolutionType& CurrentSol, SolutionType& BestSol, PairSetType& PairSet);
+    void UpdatePenaltyMatrix(const SolutionType& Solution);
+    int RescaledPenalty(int Penalty, int Rescales) const;
+    void SyncPenalties();
+    template <Objective Mode>
+    void InitializePrecalcMatrixes(const SolutionType& Solution, WorkspaceType& Work);
+    template <Objective Mode>
+    void UpdatePrecalcMatrixes(const SolutionType& Solution, std::pair<int, int> BestCandidate, WorkspaceType& Work);
+    template <Objective Mode>
+    void VerifyIncrementalState(const SolutionType& Solution, int SolutionCost, WorkspaceType& Work);
+    void AdjustConflictDegree(WorkspaceType& Work, int Node, int Change);
+    void CollectGapColors(const SolutionType& Solution, int Node, WorkspaceType& Work);
+    int SumConstraintViolations(const SolutionType& Solution);
+    int AugmentedSumConstraintViolations(const SolutionType& Solution);
+    int DistanceHamming(const SolutionType& Solution);
+    SolutionType GenerateRandomSolution();
+    void MixedPathRelinking(const SolutionType& FirstParent, const SolutionType& SecondParent, WorkspaceType& Work, SolutionType& Child);
+};
@@ -1,30 +1,62 @@
-#include <iostream>
-#include <fstream>
-#include <string>
-#include <chrono>
-#include <filesystem>
-#include <map>
-#include <opencv2/opencv.hpp>
-
-#include "Solver.h"
-
-#include "UETT.h"
-
-int main()
-{
-
-    std::string Instance = R"(C:\Users\lucian.isac\source\repos\Bandwith Coloring Problem\Bandwith Coloring Problem\Instances\UETT_Instances\generated_json)";
-
-    for (const auto& entry : fs::directory_iterator(Instance)) {
-        if (entry.is_regular_file()) {
-            UETT solv(entry.path().string());
-            solv.Solve();
-        }
-    }
-    
-    return 0;
-
-    std::string InstancesPath = "D:\\BCP_Instances";
-    Solver sol(InstancesPath);
-    sol.Solve();
-}
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <map>
+
+#include "Solver.h"
+#include "UETT.h"
+#include "CommandLine.h"
+
+int main(int argc, char** argv)
+{
+    CommandLine Args;
+    try
+    {
+        Args = CommandLine::Parse(argc, argv);
+    }
+    catch (const std::invalid_argument& Ex)
+    {
+        std::cerr << Ex.what() << "\n" << CommandLine::Usage(argv[0]);
+        return 2;
+    }
+    if (Args.Help)
+    {
+        std::cout << CommandLine::Usage(argv[0]);
+        return 0;
+    }
+
+    std::unique_ptr<RenderQueue> Renderer;
+    if (Args.Render)
+    {
+        Renderer = std::make_unique<RenderQueue>(Args.Python);
+        Args.Export.Renderer = Renderer.get();
+    }
+
+    try
+    {
+        if (Args.Problem == "uett")
+        {
+            BatchDriver Driver(Args.Options.NoThreads);
+            for (const auto& FileName : Args.InputFiles(".json"))
+                Driver.Add(std::make_unique<UETT>(FileName, Args.Options, Args.Export));
+            Driver.Run();
+            std::cout << "Output queue: " + Driver.GetOutput().Describe() + "\n";
+        }
+        else
+        {
+            Solver sol(Args.InputFiles(".col"), Args.DefaultOutputPath(), Args.Options, Args.Export);
+            sol.Solve();
+        }
+    }
+    catch (const std::invalid_argument& Ex)
+    {
+        std::cerr << Ex.what() << "\n";
+        return 2;
+    }
+
+    if (Renderer)
+        Renderer->Flush();
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "OutputPipeline.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+OutputPipeline::OutputPipeline(size_t Capacity, int NoThreads)
+    : Capacity(std::max<size_t>(1, Capacity))
+{
+    for (int Index = 0; Index < std::max(1, NoThreads); ++Index)
+        Workers.emplace_back(&OutputPipeline::WorkerLoop, this);
+}
+//------------------------------------------------------------------------------------------------
+
+OutputPipeline::~OutputPipeline()
+{
+    {
+        std::lock_guard<std::mutex> Guard(Lock);
+        Stopping = true;
+    }
+    NotEmpty.notify_all();
+
+    for (auto& Worker : Workers)
+        Worker.join();
+}
+//------------------------------------------------------------------------------------------------
+
+void OutputPipeline::Push(Record Work)
+{
+    std::unique_lock<std::mutex> Guard(Lock);
+    if (Queue.size() >= Capacity)
+    {
+        auto BlockStart = std::chrono::high_resolution_clock::now();
+        NotFull.wait(Guard, [&] { return Queue.size() < Capacity; });
+        std::chrono::duration<double> Blocked = std::chrono::high_resolution_clock::now() - BlockStart;
+
+        ++Stats.BlockedPushes;
+        Stats.BlockedSeconds += Blocked.count();
+    }
+
+    Queue.push_back(std::move(Work));
+    ++Stats.Pushed;
+    Stats.MaxDepth = std::max(Stats.MaxDepth, Queue.size());
+    Guard.unlock();
+    NotEmpty.notify_one();
+}
+//------------------------------------------------------------------------------------------------
+
+void OutputPipeline::Drain()
+{
+    std::unique_lock<std::mutex> Guard(Lock);
+    Idle.wait(Guard, [&] { return Queue.empty() && Busy == 0; });
+}
+//------------------------------------------------------------------------------------------------
+
+OutputPipeline::Metrics OutputPipeline::GetMetrics()
+{
+    std::lock_guard<std::mutex> Guard(Lock);
+    return Stats;
+}
+//------------------------------------------------------------------------------------------------
+
+std::string OutputPipeline::Describe()
+{
+    Metrics Current = GetMetrics();
+    std::ostringstream Out;
+    Out << std::fixed << std::setprecision(3)
+        << "records " << Current.Pushed << ", max depth " << Current.MaxDepth << "/" << Capacity
+        << ", blocked pushes " << Current.BlockedPushes << " (" << Current.BlockedSeconds << " s)"
+        << ", write time " << Current.WriteSeconds << " s";
+    return Out.str();
+}
+//------------------------------------------------------------------------------------------------
+
+void OutputPipeline::WorkerLoop()
+{
+    std::unique_lock<std::mutex> Guard(Lock);
+    while (true)
+    {
+        NotEmpty.wait(Guard, [&] { return Stopping || !Queue.empty(); });
+        if (Queue.empty())
+            return;
+
+        Record Work = std::move(Queue.front());
+        Queue.pop_front();
+        ++Busy;
+        Guard.unlock();
+        NotFull.notify_one();
+
+        auto WriteStart = std::chrono::high_resolution_clock::now();
+        try
+        {
+            Work();
+        }
+        catch (const std::exception& Ex)
+        {
+            std::cerr << std::string("Output failed: ") + Ex.what() + "\n";
+        }
+        std::chrono::duration<double> Written = std::chrono::high_resolution_clock::now() - WriteStart;
+
+        Guard.lock();
+        Stats.WriteSeconds += Written.count();
+        --Busy;
+        if (Queue.empty() && Busy == 0)
+            Idle.notify_all();
+    }
+}
+//------------------------------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <string>
+
+// Bounded queue drained by dedicated I/O threads. Solver threads push finished
+// output work (logs, stats rows, exports) and go back to solving; they only wait
+// when the queue is full, and that waiting is recorded in the metrics.
+class OutputPipeline
+{
+public:
+    using Record = std::function<void()>;
+
+    struct Metrics
+    {
+        size_t Pushed = 0;
+        size_t MaxDepth = 0;
+        size_t BlockedPushes = 0;
+        double BlockedSeconds = 0;
+        double WriteSeconds = 0;
+    };
+
+    explicit OutputPipeline(size_t Capacity = 64, int NoThreads = 1);
+    ~OutputPipeline();
+
+    void Push(Record Work);
+    void Drain();
+    Metrics GetMetrics();
+    std::string Describe();
+
+private:
+    size_t Capacity;
+    std::deque<Record> Queue;
+    std::vector<std::thread> Workers;
+    std::mutex Lock;
+    std::condition_variable NotEmpty;
+    std::condition_variable NotFull;
+    std::condition_variable Idle;
+    int Busy = 0;
+    bool Stopping = false;
+    Metrics Stats;
+
+    void WorkerLoop();
+};
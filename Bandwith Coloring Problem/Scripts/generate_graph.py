@@ -33,13 +33,14 @@ def generate_graph(tmp_path):
 
     edge_labels = nx.get_edge_attributes(G, 'label')
     nx.draw_networkx_edge_labels(G, pos, edge_labels=edge_labels, bbox={'facecolor':'white', 'edgecolor':'none', 'pad':0.5}, font_size=12)
-    plt.savefig(directory + '\\' + filename + '.png', format="png")
+    plt.savefig(os.path.join(directory, filename + '.png'), format="png")
+    plt.close()
 
 
 if __name__ == "__main__":
-    if len(sys.argv) != 2:
-        print("Usage: python draw_graph.py <edges> <node_values> <name>")
+    if len(sys.argv) < 2:
+        print("Usage: python generate_graph.py <tmp_path> [<tmp_path> ...]")
         sys.exit(1)
 
-    tmp_path = sys.argv[1]
-    generate_graph(tmp_path)
\ No newline at end of file
+    for tmp_path in sys.argv[1:]:
+        generate_graph(tmp_path)
\ No newline at end of file
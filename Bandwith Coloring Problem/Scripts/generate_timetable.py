@@ -106,14 +106,15 @@ def generate_timetable(tmp_path):
 
     fig.set_size_inches(ncols * cell_width * 15, (nrows + 2) * cell_height * 15)
 
-    plt.savefig(directory + '\\' + filename + '.png', format="png")
+    plt.savefig(os.path.join(directory, filename + '.png'), format="png")
+    plt.close()
 
 
 if __name__ == "__main__":
-    if len(sys.argv) != 2:
-        print("Usage: python draw_graph.py <edges> <node_values> <name>")
+    if len(sys.argv) < 2:
+        print("Usage: python generate_timetable.py <tmp_path> [<tmp_path> ...]")
         sys.exit(1)
 
-    tmp_path = sys.argv[1]
-    generate_timetable(tmp_path)
+    for tmp_path in sys.argv[1:]:
+        generate_timetable(tmp_path)
 
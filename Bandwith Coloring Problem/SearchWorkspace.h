@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+#include "SolutionPool.h"
+
+// Scratch state of the LPR kernels. One workspace belongs to one search, and so to one
+// thread; it is sized once for the instance and reused by every tabu search and path
+// relinking, so the steady state of a search does not touch the heap.
+template <typename Color, typename Total>
+struct SearchWorkspace
+{
+    using SolutionType = PooledSolution<Color>;
+    using DeltaMatrix = std::vector<std::vector<Total>>;
+
+    // Tabu search. TabuExpiry holds, per node and color, the iteration up to which
+    // the move stays tabu.
+    SolutionType BestSol;
+    DeltaMatrix ColorChangeSum;
+    DeltaMatrix ColorChangeWeightSum;
+    std::vector<int> TabuExpiry;
+    std::vector<std::pair<int, int>> BestCandidateList;
+    std::vector<std::pair<int, int>> BestCandidateListTabu;
+    std::vector<int> Candidates;
+    std::vector<int> GapColors;
+    std::vector<std::pair<int, int>> Windows;
+
+    // Nodes of the searched solution with at least one violated edge, as an indexed sparse
+    // set, and the number of violated edges per node. Kept by the precalc kernels.
+    std::vector<int> ConflictDegree;
+    std::vector<int> ConflictNodes;
+    std::vector<int> ConflictIndex;
+
+    // Path relinking.
+    std::vector<int> DiffPos;
+    SolutionType Last;
+    SolutionType PrevLast;
+
+    void Reserve(int NoNodes, int NoColors, int MaxDegree, int NoRandCandidates, int GapSamples)
+    {
+        BestSol.reserve(NoNodes);
+        ColorChangeSum.assign(NoNodes, std::vector<Total>(NoColors + 1));
+        ColorChangeWeightSum.assign(NoNodes, std::vector<Total>(NoColors + 1));
+        TabuExpiry.reserve((size_t)NoNodes * (NoColors + 1));
+        BestCandidateList.reserve(NoRandCandidates);
+        BestCandidateListTabu.reserve(NoRandCandidates);
+        Candidates.reserve(NoNodes);
+        GapColors.reserve(NoColors + GapSamples + 2);
+        Windows.reserve(MaxDegree);
+        ConflictDegree.reserve(NoNodes);
+        ConflictNodes.reserve(NoNodes);
+        ConflictIndex.reserve(NoNodes);
+        DiffPos.reserve(NoNodes);
+        Last.reserve(NoNodes);
+        PrevLast.reserve(NoNodes);
+    }
+};
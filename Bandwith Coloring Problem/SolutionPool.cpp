@@ -0,0 +1,129 @@
+#include "SolutionPool.h"
+
+#include <new>
+#include <algorithm>
+
+namespace
+{
+    const size_t Granularity = alignof(std::max_align_t);
+    // Bounds of one thread's cache: the number of block sizes kept at a time and the bytes
+    // kept per size. Blocks beyond them go straight back to the heap.
+    const size_t MaxClasses = 16;
+    const size_t MaxClassBytes = 4 << 20;
+    const size_t MaxClassBlocks = 1024;
+
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    struct SizeClass
+    {
+        size_t Bytes;
+        size_t Count;
+        FreeBlock* Head;
+    };
+
+    // The free lists of one thread. Only blocks on the free lists belong to it; blocks in use
+    // may be owned by objects on any thread and are never released here.
+    struct ThreadCache
+    {
+        std::vector<SizeClass> Classes;
+
+        ~ThreadCache();
+
+        void Release()
+        {
+            for (auto& Class : Classes)
+            {
+                while (Class.Head != nullptr)
+                {
+                    FreeBlock* Block = Class.Head;
+                    Class.Head = Block->Next;
+                    ::operator delete(Block);
+                }
+            }
+            Classes.clear();
+        }
+
+        SizeClass* Find(size_t Bytes)
+        {
+            for (auto& Class : Classes)
+            {
+                if (Class.Bytes == Bytes)
+                    return &Class;
+            }
+            return nullptr;
+        }
+
+        // The class of Bytes, taking over a drained class when all slots are in use;
+        // nullptr when every class still caches blocks.
+        SizeClass* FindOrAdd(size_t Bytes)
+        {
+            if (SizeClass* Class = Find(Bytes))
+                return Class;
+            for (auto& Class : Classes)
+            {
+                if (Class.Head == nullptr)
+                {
+                    Class = { Bytes, 0, nullptr };
+                    return &Class;
+                }
+            }
+            if (Classes.size() == MaxClasses)
+                return nullptr;
+            Classes.reserve(MaxClasses);
+            Classes.push_back({ Bytes, 0, nullptr });
+            return &Classes.back();
+        }
+    };
+
+    thread_local ThreadCache Cache;
+    // Objects destroyed after the cache of their thread, statics among them, free to the heap.
+    thread_local bool CacheDestroyed = false;
+
+    ThreadCache::~ThreadCache()
+    {
+        Release();
+        CacheDestroyed = true;
+    }
+
+    size_t RoundUp(size_t Bytes)
+    {
+        return (Bytes + Granularity - 1) / Granularity * Granularity;
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+void* SolutionPool::Allocate(size_t Bytes)
+{
+    Bytes = RoundUp(Bytes > 0 ? Bytes : 1);
+    SizeClass* Class = CacheDestroyed ? nullptr : Cache.Find(Bytes);
+    if (Class != nullptr && Class->Head != nullptr)
+    {
+        FreeBlock* Block = Class->Head;
+        Class->Head = Block->Next;
+        --Class->Count;
+        return Block;
+    }
+    return ::operator new(Bytes);
+}
+//------------------------------------------------------------------------------------------------
+
+void SolutionPool::Deallocate(void* Block, size_t Bytes)
+{
+    if (Block == nullptr)
+        return;
+    Bytes = RoundUp(Bytes > 0 ? Bytes : 1);
+    SizeClass* Class = CacheDestroyed ? nullptr : Cache.FindOrAdd(Bytes);
+    if (Class == nullptr || Class->Count >= std::min(MaxClassBlocks, MaxClassBytes / Bytes))
+    {
+        ::operator delete(Block);
+        return;
+    }
+    FreeBlock* Free = static_cast<FreeBlock*>(Block);
+    Free->Next = Class->Head;
+    Class->Head = Free;
+    ++Class->Count;
+}
+//------------------------------------------------------------------------------------------------
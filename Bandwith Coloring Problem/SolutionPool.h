@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Free lists of fixed-size blocks, one set per thread. Solutions, population and pair
+// set nodes all come in a handful of sizes per instance, so after the first restart
+// every allocation is a pop from the calling thread's list and never takes the global
+// heap lock. A block freed on another thread joins that thread's list. The lists are
+// bounded in sizes and bytes and go back to the heap when their thread exits, so the
+// searches sharing a worker keep reusing each other's blocks until the pool shuts down.
+class SolutionPool
+{
+public:
+    static void* Allocate(size_t Bytes);
+    static void Deallocate(void* Block, size_t Bytes);
+};
+
+template <typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t Count) { return static_cast<T*>(SolutionPool::Allocate(Count * sizeof(T))); }
+    void deallocate(T* Block, size_t Count) { SolutionPool::Deallocate(Block, Count * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+template <typename Color>
+using PooledSolution = std::vector<Color, PoolAllocator<Color>>;
@@ -1,28 +1,79 @@
-#pragma once
-
-#include <iostream>
-#include <fstream>
-#include <string>
-#include <chrono>
-#include <filesystem>
-#include <map>
-#include <opencv2/opencv.hpp>
-
-#include "LPR.h"
-
-class Solver
-{
-    const int PopulationSize = 20;
-    std::string InstancesPath;
-    std::string OutputPath;
-    std::string OutStatsPath;
-public:
-    Solver(std::string InstancesPath);
-    void Solve();
-
-    static void ComputeGraphImge(int NoNodes, std::vector<std::vector<int>> Graph, std::vector<int> BestSol, std::string TempPath);
-private:
-    void ReadData(std::string FileName, int& NoNodes, int& NoEdges, int& KBest, std::vector<std::vector<int>>& Graph);
-
-};
-
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+
+#include "LPR.h"
+#include "BatchDriver.h"
+#include "GraphExport.h"
+
+// Shared by all instances of a batch; WriteOutput appends to it under Lock.
+struct SolverStats
+{
+    std::ofstream Fout;
+    std::mutex Lock;
+    LPRCounters Totals;
+};
+
+// How a batch is run: replica r of an instance is seeded with Seed + r, or from
+// random_device when no seed is given.
+struct RunOptions
+{
+    int Replicas = 20;
+    std::optional<unsigned> Seed;
+    int NoThreads = 0;
+    LPRParameters Parameters;
+
+    unsigned ReplicaSeed(int Replica) const { return Seed ? *Seed + Replica : std::random_device()(); }
+};
+
+class Solver
+{
+    std::vector<std::string> FileNames;
+    std::string OutputPath;
+    std::string OutStatsPath;
+    RunOptions Options;
+    ExportOptions Export;
+public:
+    Solver(std::vector<std::string> FileNames, std::string OutputPath, RunOptions Options = {}, ExportOptions Export = {});
+    void Solve();
+
+    static void ReadData(std::string FileName, int& NoNodes, int& NoEdges, int& KBest, std::vector<std::vector<int>>& Graph);
+};
+
+// A single .col instance solved Options.Replicas times; replicas run as separate pool tasks.
+class BCPInstance : public BatchJob
+{
+    std::string FileName;
+    std::string OutputPath;
+    RunOptions Options;
+    int Instances;
+    SolverStats& Stats;
+    ExportOptions Export;
+    ThreadPool* Pool = nullptr;
+
+    int NoNodes = 0;
+    int NoEdges = 0;
+    int KBest = 0;
+    std::vector<std::vector<int>> Graph;
+    std::vector<std::vector<int>> Solutions;
+    std::vector<double> Durations;
+    std::vector<LPRCounters> Counters;
+    std::vector<std::unique_ptr<ConvergenceTrace>> Traces;
+    std::chrono::high_resolution_clock::time_point TotalTimeStart;
+public:
+    BCPInstance(std::string FileName, std::string OutputPath, const RunOptions& Options, SolverStats& Stats, ExportOptions Export);
+
+    std::string Name() const override;
+    void Load(ThreadPool& Pool) override;
+    int NoReplicas() const override;
+    void SolveReplica(int Replica) override;
+    void WriteOutput() override;
+};
@@ -0,0 +1,234 @@
+#include "SolverBenchmark.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#endif
+
+namespace
+{
+    double Percentile(std::vector<double> Values, double Fraction)
+    {
+        if (Values.empty())
+            return -1;
+        std::sort(Values.begin(), Values.end());
+        size_t Rank = (size_t)std::ceil(Fraction * Values.size());
+        return Values[std::clamp<size_t>(Rank, 1, Values.size()) - 1];
+    }
+
+    nlohmann::json Seconds(double Value)
+    {
+        return Value < 0 ? nlohmann::json() : nlohmann::json(Value);
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+SolverBenchmark::SolverBenchmark(BenchmarkConfig Config)
+    : Config(std::move(Config))
+{
+}
+//------------------------------------------------------------------------------------------------
+
+void SolverBenchmark::Run()
+{
+    Results.clear();
+    std::vector<std::string> Instances;
+    for (const auto& FileName : BatchDriver::ListInstances(Config.InstancesPath, ".col"))
+        if (Config.Filter.empty() || FileName.find(Config.Filter) != std::string::npos)
+            Instances.push_back(FileName);
+
+    for (int NoThreads : Config.ThreadCounts)
+    {
+        for (const auto& FileName : Instances)
+        {
+            Results.push_back(RunInstance(FileName, NoThreads));
+            const auto& Result = Results.back();
+            std::cout << Result.Instance << " threads=" << NoThreads << " SR=" << Result.NoSuccess << "/" << Result.NoRuns
+                << " median=" << Result.MedianTimeToFeasible << "s p90=" << Result.P90TimeToFeasible << "s it/s="
+                << (int64_t)Result.IterationsPerSecond << " rss=" << Result.PeakRssKb << "kB\n";
+        }
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+BenchmarkResult SolverBenchmark::RunInstance(const std::string& FileName, int NoThreads)
+{
+    int NoNodes = 0, NoEdges = 0, KBest = 0;
+    std::vector<std::vector<int>> Graph;
+    Solver::ReadData(FileName, NoNodes, NoEdges, KBest, Graph);
+
+    size_t NoRuns = Config.Seeds.size();
+    std::vector<double> Durations(NoRuns, 0);
+    std::vector<int64_t> Iterations(NoRuns, 0);
+    std::vector<char> Success(NoRuns, 0);
+
+    ResetPeakRss();
+    auto WallStart = std::chrono::steady_clock::now();
+    {
+        ThreadPool Pool(NoThreads);
+        for (size_t Run = 0; Run < NoRuns; ++Run)
+        {
+            Pool.Submit([&, Run] {
+                auto Start = std::chrono::steady_clock::now();
+                LPR Solver(NoNodes, NoEdges, KBest, Graph, Config.Parameters, Config.Seeds[Run]);
+                Solver.SetPool(&Pool);
+                Success[Run] = !Solver.Solve().empty();
+                std::chrono::duration<double> Duration = std::chrono::steady_clock::now() - Start;
+                Durations[Run] = Duration.count();
+                Iterations[Run] = Solver.GetTabuIterations();
+            });
+        }
+        Pool.Wait();
+    }
+    std::chrono::duration<double> Wall = std::chrono::steady_clock::now() - WallStart;
+
+    BenchmarkResult Result;
+    Result.Instance = std::filesystem::path(FileName).stem().string();
+    Result.NoThreads = NoThreads;
+    Result.NoRuns = (int)NoRuns;
+    Result.WallSeconds = Wall.count();
+    Result.PeakRssKb = PeakRssKb();
+
+    std::vector<double> TimesToFeasible;
+    double TotalSeconds = 0;
+    int64_t TotalIterations = 0;
+    for (size_t Run = 0; Run < NoRuns; ++Run)
+    {
+        if (Success[Run])
+            TimesToFeasible.push_back(Durations[Run]);
+        TotalSeconds += Durations[Run];
+        TotalIterations += Iterations[Run];
+    }
+    Result.NoSuccess = (int)TimesToFeasible.size();
+    Result.MedianTimeToFeasible = Percentile(TimesToFeasible, 0.5);
+    Result.P90TimeToFeasible = Percentile(TimesToFeasible, 0.9);
+    Result.IterationsPerSecond = TotalSeconds > 0 ? TotalIterations / TotalSeconds : 0;
+    return Result;
+}
+//------------------------------------------------------------------------------------------------
+
+nlohmann::json SolverBenchmark::ToJson() const
+{
+    nlohmann::json Root;
+    Root["seeds"] = Config.Seeds;
+    Root["population_size"] = Config.Parameters.PopulationSize;
+    Root["time_limit"] = Config.Parameters.TimeLimit;
+    Root["neighbourhood"] = Config.Parameters.ExactNeighbourhood ? "exact" : "gap";
+    Root["results"] = nlohmann::json::array();
+    for (const auto& Result : Results)
+    {
+        Root["results"].push_back({
+            { "instance", Result.Instance },
+            { "threads", Result.NoThreads },
+            { "runs", Result.NoRuns },
+            { "success", Result.NoSuccess },
+            { "success_rate", Result.SuccessRate() },
+            { "median_time_to_feasible", Seconds(Result.MedianTimeToFeasible) },
+            { "p90_time_to_feasible", Seconds(Result.P90TimeToFeasible) },
+            { "iterations_per_second", Result.IterationsPerSecond },
+            { "wall_seconds", Result.WallSeconds },
+            { "peak_rss_kb", Result.PeakRssKb }
+        });
+    }
+    return Root;
+}
+//------------------------------------------------------------------------------------------------
+
+void SolverBenchmark::WriteResults() const
+{
+    std::ofstream Fout(Config.OutputPath);
+    Fout << ToJson().dump(2) << "\n";
+}
+//------------------------------------------------------------------------------------------------
+
+int SolverBenchmark::CompareToBaseline() const
+{
+    // Success rate is compared in absolute terms, everything else relative to the baseline.
+    if (Config.BaselinePath.empty())
+        return 0;
+
+    std::ifstream Fin(Config.BaselinePath);
+    if (!Fin)
+        throw std::runtime_error("cannot open baseline " + Config.BaselinePath);
+    nlohmann::json Baseline = nlohmann::json::parse(Fin);
+
+    std::map<std::pair<std::string, int>, const nlohmann::json*> Previous;
+    for (const auto& Entry : Baseline["results"])
+        Previous[{ Entry["instance"].get<std::string>(), Entry["threads"].get<int>() }] = &Entry;
+
+    int NoRegressions = 0;
+    auto Report = [&](const BenchmarkResult& Result, const std::string& Metric, double Before, double After) {
+        std::cout << "REGRESSION " << Result.Instance << " threads=" << Result.NoThreads << " " << Metric
+            << ": " << Before << " -> " << After << "\n";
+        ++NoRegressions;
+    };
+
+    double Threshold = Config.Threshold;
+    for (const auto& Result : Results)
+    {
+        auto It = Previous.find({ Result.Instance, Result.NoThreads });
+        if (It == Previous.end())
+            continue;
+        const nlohmann::json& Before = *It->second;
+
+        double SuccessRate = Before["success_rate"].get<double>();
+        if (Result.SuccessRate() < SuccessRate - Threshold)
+            Report(Result, "success_rate", SuccessRate, Result.SuccessRate());
+
+        if (!Before["median_time_to_feasible"].is_null())
+        {
+            double Median = Before["median_time_to_feasible"].get<double>();
+            if (Result.MedianTimeToFeasible < 0 || Result.MedianTimeToFeasible > Median * (1 + Threshold))
+                Report(Result, "median_time_to_feasible", Median, Result.MedianTimeToFeasible);
+        }
+
+        double IterationsPerSecond = Before["iterations_per_second"].get<double>();
+        if (Result.IterationsPerSecond < IterationsPerSecond * (1 - Threshold))
+            Report(Result, "iterations_per_second", IterationsPerSecond, Result.IterationsPerSecond);
+
+        double PeakRss = Before["peak_rss_kb"].get<double>();
+        if (PeakRss > 0 && Result.PeakRssKb > PeakRss * (1 + Threshold))
+            Report(Result, "peak_rss_kb", PeakRss, (double)Result.PeakRssKb);
+    }
+    return NoRegressions;
+}
+//------------------------------------------------------------------------------------------------
+
+int64_t SolverBenchmark::PeakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS Counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)))
+        return (int64_t)(Counters.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+    std::ifstream Fin("/proc/self/status");
+    std::string Line;
+    while (std::getline(Fin, Line))
+        if (Line.rfind("VmHWM:", 0) == 0)
+            return std::stoll(Line.substr(6));
+    return 0;
+#endif
+}
+//------------------------------------------------------------------------------------------------
+
+void SolverBenchmark::ResetPeakRss()
+{
+    // Linux lets a process reset its high-water mark; elsewhere the peak is cumulative.
+#ifndef _WIN32
+    std::ofstream Fout("/proc/self/clear_refs");
+    Fout << "5";
+#endif
+}
+//------------------------------------------------------------------------------------------------
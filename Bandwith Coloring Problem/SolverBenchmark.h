@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "json.hpp"
+#include "LPRParameters.h"
+
+struct BenchmarkConfig
+{
+    std::string InstancesPath;
+    std::string Filter;
+    std::vector<unsigned> Seeds = { 1, 2, 3, 4, 5 };
+    std::vector<int> ThreadCounts = { 1 };
+    LPRParameters Parameters;
+    std::string OutputPath = "benchmark.json";
+    std::string BaselinePath;
+    double Threshold = 0.10;
+};
+
+// Results of one instance solved once per seed on a pool of NoThreads threads.
+struct BenchmarkResult
+{
+    std::string Instance;
+    int NoThreads = 0;
+    int NoRuns = 0;
+    int NoSuccess = 0;
+    double MedianTimeToFeasible = -1;
+    double P90TimeToFeasible = -1;
+    double IterationsPerSecond = 0;
+    double WallSeconds = 0;
+    int64_t PeakRssKb = 0;
+
+    double SuccessRate() const { return NoRuns == 0 ? 0 : 1.0 * NoSuccess / NoRuns; }
+};
+
+// End-to-end regression runner over a directory of .col instances: every
+// instance is solved with every seed, once per thread count, and the summary is
+// compared against a stored baseline with a relative regression threshold.
+class SolverBenchmark
+{
+    BenchmarkConfig Config;
+    std::vector<BenchmarkResult> Results;
+public:
+    explicit SolverBenchmark(BenchmarkConfig Config);
+
+    void Run();
+    void WriteResults() const;
+    int CompareToBaseline() const;
+    const std::vector<BenchmarkResult>& GetResults() const { return Results; }
+
+    static int64_t PeakRssKb();
+    static void ResetPeakRss();
+private:
+    BenchmarkResult RunInstance(const std::string& FileName, int NoThreads);
+    nlohmann::json ToJson() const;
+};
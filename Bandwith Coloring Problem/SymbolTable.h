@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Assigns dense integer ids to names in the order they are first seen.
+class SymbolTable
+{
+    std::vector<std::string> Names;
+    std::unordered_map<std::string, int> Ids;
+public:
+    int Intern(const std::string& Name)
+    {
+        auto [It, Inserted] = Ids.try_emplace(Name, (int)Names.size());
+        if (Inserted)
+            Names.push_back(Name);
+        return It->second;
+    }
+
+    int Find(const std::string& Name) const
+    {
+        auto It = Ids.find(Name);
+        return It == Ids.end() ? -1 : It->second;
+    }
+
+    const std::string& Name(int Id) const { return Names[Id]; }
+    int Size() const { return (int)Names.size(); }
+};
@@ -0,0 +1,189 @@
+#include "ThreadPool.h"
+
+#include <cassert>
+
+namespace
+{
+    thread_local ThreadPool* CurrentPool = nullptr;
+    thread_local int CurrentWorker = -1;
+}
+
+ThreadPool::ThreadPool(int NoThreads)
+{
+    if (NoThreads <= 0)
+        NoThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int Index = 0; Index < NoThreads; ++Index)
+        Queues.push_back(std::make_unique<WorkerQueue>());
+
+    for (int Index = 0; Index < NoThreads; ++Index)
+        Workers.emplace_back(&ThreadPool::WorkerLoop, this, Index);
+}
+//------------------------------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool()
+{
+    Wait();
+    {
+        std::lock_guard<std::mutex> Guard(SleepLock);
+        Stopping = true;
+    }
+    WakeUp.notify_all();
+
+    for (auto& Worker : Workers)
+        Worker.join();
+}
+//------------------------------------------------------------------------------------------------
+
+int ThreadPool::Size() const
+{
+    return Workers.size();
+}
+//------------------------------------------------------------------------------------------------
+
+void ThreadPool::Submit(Task Job)
+{
+    ++Pending;
+    ++Queued;
+
+    int Index;
+    if (CurrentPool == this)
+        Index = CurrentWorker;
+    else
+        Index = NextQueue++ % Queues.size();
+
+    {
+        std::lock_guard<std::mutex> Guard(Queues[Index]->Lock);
+        Queues[Index]->Tasks.push_back(std::move(Job));
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(SleepLock);
+    }
+    WakeUp.notify_one();
+}
+//------------------------------------------------------------------------------------------------
+
+void ThreadPool::Wait()
+{
+    assert(CurrentPool != this);
+
+    std::unique_lock<std::mutex> Guard(SleepLock);
+    Idle.wait(Guard, [&] { return Pending == 0; });
+}
+//------------------------------------------------------------------------------------------------
+
+void ThreadPool::ParallelFor(int Count, const std::function<void(int)>& Body)
+{
+    if (Count <= 0)
+        return;
+
+    struct LoopState
+    {
+        std::atomic<int> Next = 0;
+        int Done = 0;
+        std::mutex Lock;
+        std::condition_variable Finished;
+    };
+
+    // Helpers that start after the loop is finished find no index left and return
+    // without touching Body, so it is safe to capture it by address.
+    auto State = std::make_shared<LoopState>();
+    const std::function<void(int)>* BodyPtr = &Body;
+    auto Drain = [State, Count, BodyPtr]() {
+        int Index;
+        while ((Index = State->Next++) < Count)
+        {
+            (*BodyPtr)(Index);
+            std::lock_guard<std::mutex> Guard(State->Lock);
+            if (++State->Done == Count)
+                State->Finished.notify_all();
+        }
+    };
+
+    int NoHelpers = std::min(Count - 1, Size());
+    for (int Helper = 0; Helper < NoHelpers; ++Helper)
+        Submit(Drain);
+
+    // The caller only works on the indices of this loop: running unrelated queued tasks
+    // here would charge them to the caller and nest them on its stack. Once no index is
+    // left, it only waits for the helpers that are still busy.
+    Drain();
+    std::unique_lock<std::mutex> Guard(State->Lock);
+    State->Finished.wait(Guard, [&] { return State->Done == Count; });
+}
+//------------------------------------------------------------------------------------------------
+
+bool ThreadPool::TryPop(int Index, Task& Job)
+{
+    std::lock_guard<std::mutex> Guard(Queues[Index]->Lock);
+    if (Queues[Index]->Tasks.empty())
+        return false;
+
+    Job = std::move(Queues[Index]->Tasks.back());
+    Queues[Index]->Tasks.pop_back();
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool ThreadPool::TrySteal(int Index, Task& Job)
+{
+    int NoQueues = Queues.size();
+    for (int Offset = 1; Offset <= NoQueues; ++Offset)
+    {
+        int Victim = (Index + Offset) % NoQueues;
+        if (Victim == Index)
+            continue;
+
+        std::lock_guard<std::mutex> Guard(Queues[Victim]->Lock);
+        if (Queues[Victim]->Tasks.empty())
+            continue;
+
+        Job = std::move(Queues[Victim]->Tasks.front());
+        Queues[Victim]->Tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------------------------
+
+bool ThreadPool::RunOne(int Index)
+{
+    Task Job;
+    if ((Index < 0 || !TryPop(Index, Job)) && !TrySteal(Index, Job))
+        return false;
+
+    --Queued;
+    Job();
+    Finish();
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+void ThreadPool::Finish()
+{
+    if (--Pending == 0)
+    {
+        std::lock_guard<std::mutex> Guard(SleepLock);
+        Idle.notify_all();
+    }
+}
+//------------------------------------------------------------------------------------------------
+
+void ThreadPool::WorkerLoop(int Index)
+{
+    CurrentPool = this;
+    CurrentWorker = Index;
+
+    while (true)
+    {
+        if (RunOne(Index))
+            continue;
+
+        std::unique_lock<std::mutex> Guard(SleepLock);
+        WakeUp.wait(Guard, [&] { return Stopping || Queued > 0; });
+        if (Stopping && Queued == 0)
+            return;
+    }
+}
+//------------------------------------------------------------------------------------------------
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops its own
+// tasks at the back and steals from the front of the other deques when it runs dry.
+// Tasks submitted from inside a worker stay on that worker's deque.
+// Wait() blocks an outside thread until the pool drains; ParallelFor() may also be
+// called from inside a task, the caller runs indices of its own loop and never other
+// queued work, so it cannot deadlock and does not pick up unrelated tasks.
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(int NoThreads = 0);
+    ~ThreadPool();
+
+    void Submit(Task Job);
+    void Wait();
+    void ParallelFor(int Count, const std::function<void(int)>& Body);
+    int Size() const;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex Lock;
+        std::deque<Task> Tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> Queues;
+    std::vector<std::thread> Workers;
+    std::mutex SleepLock;
+    std::condition_variable WakeUp;
+    std::condition_variable Idle;
+    std::atomic<int> Queued = 0;
+    std::atomic<int> Pending = 0;
+    std::atomic<unsigned> NextQueue = 0;
+    bool Stopping = false;
+
+    bool TryPop(int Index, Task& Job);
+    bool TrySteal(int Index, Task& Job);
+    bool RunOne(int Index);
+    void Finish();
+    void WorkerLoop(int Index);
+};
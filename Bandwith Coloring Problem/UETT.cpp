@@ -1,169 +1,297 @@
-#include "UETT.h"
-
-UETT::UETT(const std::string& filename)
-{
-    Path = filename;
-    OutputPath = fs::path(Path).parent_path() / "Output";
-    std::string FileNameWithoutExtension = fs::path(Path).stem().string();
-    OutputPath_graph = OutputPath / (FileNameWithoutExtension + "_graph.tmp");
-    OutputPath_timetable = OutputPath / (FileNameWithoutExtension + "_timetable.tmp");
-
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file");
-    }
-
-    json j;
-    file >> j;
-
-    ParseJson(j);
-    CreateGraph();
-}
-
-void UETT::Solve()
-{
-    int NoNodes = 0, NoEdges = 0;
-    std::vector<std::vector<int>> Edges;
-    
-    int it = 0;
-    for (const auto& node : Graph) {
-        int_to_str[it] = node.first;
-        str_to_int[node.first] = it;
-        ++it;
-        ++NoNodes;
-        NoEdges += node.second.size();
-    }
-    
-    NoEdges /= 2;
-    Edges.resize(NoNodes);
-    it = 0;
-    for (const auto& node : Graph) {
-        Edges[str_to_int[node.first]].resize(NoNodes);
-        for (const auto& neighbor : node.second) {
-            int cost_1;
-            if (Difficulties[node.first] == "easy")
-                cost_1 = 1;
-            else if (Difficulties[node.first] == "medium")
-                cost_1 = 2;
-            else
-                cost_1 = 3;
-
-            int cost_2;
-            if (Difficulties[neighbor] == "easy")
-                cost_2 = 1;
-            else if (Difficulties[neighbor] == "medium")
-                cost_2 = 2;
-            else
-                cost_2 = 3;
-
-            Edges[str_to_int[node.first]][str_to_int[neighbor]] = std::min(cost_1, cost_2);
-        }
-        ++it;
-    }
-    LPR solution(NoNodes, NoEdges, 15, 20, Edges);
-    std::vector<int> cols = solution.Solve();
-    if (cols.size() > 0)
-    {
-        Solver::ComputeGraphImge(NoNodes, Edges, cols, OutputPath_graph.string());
-        ComputeTimetableImage(cols, OutputPath_timetable.string());
-    }
-}
-
-
-void UETT::ParseJson(const json& j)
-{
-    for (auto& [key, value] : j["mandatory_exams"].items()) {
-        Difficulties[value[0]] = value[1];
-    }
-
-    for (auto& [key, value] : j["optional_packs"].items()) {
-        for (const auto& exam : value[0]) {
-            Difficulties[exam] = value[1];
-        }
-    }
-
-    for (auto& [key, value] : j["students"].items()) {
-        for (const auto& exam : value) {
-            ExamToStudents[exam].insert(key);
-        }
-    }
-}
-
-void UETT::CreateGraph()
-{
-    for (const auto& [exam1, students1] : ExamToStudents) {
-        for (const auto& [exam2, students2] : ExamToStudents) {
-            if (exam1 != exam2) {
-                std::vector<std::string> sharedStudents;
-                std::set_intersection(students1.begin(), students1.end(),
-                    students2.begin(), students2.end(),
-                    std::back_inserter(sharedStudents));
-                if (!sharedStudents.empty()) {
-                    Graph[exam1].insert(exam2);
-                }
-            }
-        }
-    }
-
-}
-
-void UETT::ComputeTimetableImage(std::vector<int> solution, std::string TempPath)
-{
-    bool First = true;
-    int it = 0;
-
-    std::string ExamsForImage = "[";
-    std::string StartForImage = "[";
-    std::string EndForImage = "[";
-    std::string ColorsForImage = "[";
-
-    std::vector<std::pair<std::string, std::string>> timeIntervals = {
-        {"08:00", "10:00"},
-        {"10:00", "12:00"},
-        {"12:00", "14:00"},
-        {"14:00", "16:00"},
-        {"16:00", "18:00"},
-        {"18:00", "20:00"}
-    };
-
-    for (auto col : solution)
-    {
-        if (First == false)
-        {
-            ExamsForImage = ExamsForImage + ", ";
-            ColorsForImage = ColorsForImage + ", ";
-            StartForImage = StartForImage + ", ";
-            EndForImage = EndForImage + ", ";
-        }
-        else
-            First = false;
-
-        ColorsForImage = ColorsForImage + std::to_string(col);
-        ExamsForImage = ExamsForImage + '\'' + int_to_str[it] + '\'';
-        ++it;
-
-        int randomIndex = std::rand() % timeIntervals.size();
-
-        std::pair<std::string, std::string> randomInterval = timeIntervals[randomIndex];
-
-        StartForImage = StartForImage + '\'' + randomInterval.first + '\'';
-        EndForImage = EndForImage + '\'' + randomInterval.second + '\'';
-    }
-
-    ExamsForImage = ExamsForImage + "]";
-    ColorsForImage = ColorsForImage + "]";
-    StartForImage = StartForImage + "]";
-    EndForImage = EndForImage + "]";
-
-    std::ofstream Fout(TempPath);
-    Fout << ExamsForImage << "\n" << ColorsForImage << "\n" << StartForImage << "\n" << EndForImage << "\n";
-    Fout.close();
-
-    std::string Command = "python Scripts/generate_timetable.py \"" + TempPath + "\"";
-    int result = system(Command.c_str());
-
-    if (result == 0)
-    {
-        std::filesystem::remove(TempPath);
-    }
-}
+#include "UETT.h"
+
+UETT::UETT(const std::string& filename, RunOptions Options, ExportOptions Export)
+{
+    Path = filename;
+    this->Options = Options;
+    this->Export = Export;
+    OutputPath = fs::path(Path).parent_path() / "Output";
+    std::string FileNameWithoutExtension = fs::path(Path).stem().string();
+    OutputPath_graph = OutputPath / (FileNameWithoutExtension + "_graph");
+    OutputPath_timetable = OutputPath / (FileNameWithoutExtension + "_timetable");
+}
+
+std::string UETT::Name() const
+{
+    return Path;
+}
+
+void UETT::Load(ThreadPool& Pool)
+{
+    this->Pool = &Pool;
+    std::ifstream file(Path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file");
+    }
+
+    UETTReader Reader;
+    Reader.Read(file);
+
+    LoadEnrolments(Reader);
+    CreateGraph(Pool);
+    SpanBound = ComputeSpanBound();
+
+    int NoNodes = Exams.Size();
+    Edges.assign(NoNodes, std::vector<int>(NoNodes, 0));
+    for (int exam = 0; exam < NoNodes; ++exam) {
+        for (int it = GraphOffsets[exam]; it < GraphOffsets[exam + 1]; ++it)
+            Edges[exam][GraphNeighbours[it]] = GraphWeights[it];
+    }
+    Solutions.assign(NoReplicas(), std::vector<int>());
+}
+
+int UETT::NoReplicas() const
+{
+    return std::max(1, Options.Replicas);
+}
+
+void UETT::SolveReplica(int Replica)
+{
+    int NoNodes = Exams.Size();
+    int NoEdges = GraphNeighbours.size() / 2;
+
+    // The population cannot be more diverse than the graph is large.
+    LPRParameters Parameters = Options.Parameters;
+    Parameters.PopulationSize = std::min(Parameters.PopulationSize, std::max(2, NoNodes));
+
+    // The greedy span always has a solution. The spans between the largest separation and
+    // the last slot of the best timetable so far are bisected: a solved span moves the upper
+    // end below the last slot its timetable uses, a failed one the lower end above it. All
+    // attempts share one time limit, and each one gets its own seed so that a failed span
+    // is not retried on the same trajectory.
+    int MinSpan = 1;
+    for (int weight : GraphWeights)
+        MinSpan = std::max(MinSpan, weight + 1);
+
+    auto Start = std::chrono::steady_clock::now();
+    double TimeLimit = Parameters.TimeLimit;
+    Solutions[Replica].clear();
+    int Low = MinSpan;
+    int High = std::max(SpanBound, MinSpan);
+    for (unsigned Attempt = 0; Low <= High; ++Attempt) {
+        // The first attempt is at the bound itself, which the greedy coloring guarantees.
+        int Span = Attempt == 0 ? High : Low + (High - Low) / 2;
+        if (TimeLimit > 0) {
+            // The time left is split evenly over the attempts bisection may still need.
+            double Left = TimeLimit - std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+            if (Left <= 0)
+                break;
+            int Attempts = (Attempt == 0) + (int)std::bit_width((unsigned)(High - Low + 1));
+            Parameters.TimeLimit = Left / Attempts;
+        }
+
+        LPR solution(NoNodes, NoEdges, Span, Edges, Parameters, Options.ReplicaSeed(Replica) + 0x9E3779B9u * Attempt);
+        solution.SetPool(Pool);
+        std::vector<int> Colors = solution.Solve();
+        if (Colors.empty()) {
+            Low = Span + 1;
+            continue;
+        }
+        High = *std::max_element(Colors.begin(), Colors.end()) - 1;
+        Solutions[Replica] = std::move(Colors);
+    }
+}
+
+void UETT::WriteOutput()
+{
+    // The replica with the fewest slots wins, the first one on ties.
+    auto Slots = [](const std::vector<int>& Solution) { return *std::max_element(Solution.begin(), Solution.end()); };
+    const std::vector<int>* Found = nullptr;
+    for (const std::vector<int>& Solution : Solutions) {
+        if (Solution.size() > 0 && (!Found || Slots(Solution) < Slots(*Found)))
+            Found = &Solution;
+    }
+    if (Found)
+    {
+        const std::vector<int>& Solution = *Found;
+        fs::create_directories(OutputPath);
+        GraphExport::Export(OutputPath_graph.string(), Exams.Size(), Edges, Solution, Export);
+        ExportTimetable(Solution, OutputPath_timetable.string());
+    }
+}
+
+
+void UETT::LoadEnrolments(UETTReader& Reader)
+{
+    Exams = std::move(Reader.Exams);
+    Difficulties = std::move(Reader.Difficulties);
+    EnrolmentOffsets = std::move(Reader.EnrolmentOffsets);
+    EnrolmentExams = std::move(Reader.EnrolmentExams);
+}
+
+void UETT::CreateGraph(ThreadPool& Pool)
+{
+    // Every student contributes one conflict for each pair of exams they sit, so the
+    // graph is built from the enrolment lists instead of intersecting all exam pairs.
+    // Students are split in chunks, each chunk counts its pairs in a private buffer
+    // and the buffers are merged once at the end.
+    int NoExams = Exams.Size();
+    int NoStudents = EnrolmentOffsets.size() - 1;
+    int NoChunks = std::max(1, std::min(NoStudents, 4 * Pool.Size()));
+    std::vector<std::vector<std::pair<uint64_t, int>>> ChunkPairs(NoChunks);
+
+    Pool.ParallelFor(NoChunks, [&](int chunk) {
+        std::vector<int> StudentExams;
+        std::vector<uint64_t> Keys;
+        int First = (int)((int64_t)NoStudents * chunk / NoChunks);
+        int Last = (int)((int64_t)NoStudents * (chunk + 1) / NoChunks);
+
+        for (int student = First; student < Last; ++student) {
+            StudentExams.assign(EnrolmentExams.begin() + EnrolmentOffsets[student], EnrolmentExams.begin() + EnrolmentOffsets[student + 1]);
+            std::sort(StudentExams.begin(), StudentExams.end());
+            StudentExams.erase(std::unique(StudentExams.begin(), StudentExams.end()), StudentExams.end());
+
+            for (int i = 0; i < (int)StudentExams.size(); ++i)
+                for (int j = i + 1; j < (int)StudentExams.size(); ++j)
+                    Keys.push_back((uint64_t)StudentExams[i] << 32 | (uint32_t)StudentExams[j]);
+        }
+
+        // Each run of equal keys is one edge, its length the students the chunk adds to it.
+        std::sort(Keys.begin(), Keys.end());
+        for (int it = 0; it < (int)Keys.size(); ) {
+            int next = it;
+            while (next < (int)Keys.size() && Keys[next] == Keys[it])
+                ++next;
+            ChunkPairs[chunk].push_back({ Keys[it], next - it });
+            it = next;
+        }
+    });
+
+    std::vector<std::pair<uint64_t, int>> Pairs;
+    for (auto& Chunk : ChunkPairs) {
+        Pairs.insert(Pairs.end(), Chunk.begin(), Chunk.end());
+        Chunk.clear();
+        Chunk.shrink_to_fit();
+    }
+    std::sort(Pairs.begin(), Pairs.end());
+
+    std::vector<std::pair<uint64_t, int>> Merged;
+    for (const auto& [key, count] : Pairs) {
+        if (!Merged.empty() && Merged.back().first == key)
+            Merged.back().second += count;
+        else
+            Merged.push_back({ key, count });
+    }
+
+    GraphOffsets.assign(NoExams + 1, 0);
+    for (const auto& [key, count] : Merged) {
+        ++GraphOffsets[(key >> 32) + 1];
+        ++GraphOffsets[(uint32_t)key + 1];
+    }
+    for (int exam = 0; exam < NoExams; ++exam)
+        GraphOffsets[exam + 1] += GraphOffsets[exam];
+
+    // Overlap counts and the separation each edge needs are written in the same
+    // pass that lays out the adjacency.
+    std::vector<int> Fill(GraphOffsets.begin(), GraphOffsets.end() - 1);
+    GraphNeighbours.resize(GraphOffsets.back());
+    GraphOverlaps.resize(GraphOffsets.back());
+    GraphWeights.resize(GraphOffsets.back());
+    for (const auto& [key, count] : Merged) {
+        int exam1 = key >> 32;
+        int exam2 = (uint32_t)key;
+        int weight = std::min((int)Difficulties[exam1], (int)Difficulties[exam2]);
+
+        GraphNeighbours[Fill[exam1]] = exam2;
+        GraphOverlaps[Fill[exam1]] = count;
+        GraphWeights[Fill[exam1]++] = weight;
+        GraphNeighbours[Fill[exam2]] = exam1;
+        GraphOverlaps[Fill[exam2]] = count;
+        GraphWeights[Fill[exam2]++] = weight;
+    }
+}
+
+int UETT::ComputeSpanBound() const
+{
+    // Greedy bandwidth coloring, heaviest exams first: every exam takes the lowest
+    // color outside the intervals blocked by its colored neighbours. Exams with the
+    // same load go by the students they share with other exams. The largest color
+    // used is a span for which LPR is guaranteed to have a solution, the replicas
+    // search downwards from it.
+    int NoExams = Exams.Size();
+    std::vector<int> Order(NoExams);
+    std::vector<int> Load(NoExams, 0);
+    std::vector<int64_t> Shared(NoExams, 0);
+    for (int exam = 0; exam < NoExams; ++exam) {
+        Order[exam] = exam;
+        for (int it = GraphOffsets[exam]; it < GraphOffsets[exam + 1]; ++it) {
+            Load[exam] += 2 * GraphWeights[it] - 1;
+            Shared[exam] += GraphOverlaps[it];
+        }
+    }
+    std::stable_sort(Order.begin(), Order.end(), [&](int e1, int e2) {
+        return Load[e1] != Load[e2] ? Load[e1] > Load[e2] : Shared[e1] > Shared[e2];
+    });
+
+    std::vector<int> Colors(NoExams, 0);
+    std::vector<std::pair<int, int>> Blocked;
+    int Span = 1;
+    for (int exam : Order) {
+        Blocked.clear();
+        for (int it = GraphOffsets[exam]; it < GraphOffsets[exam + 1]; ++it) {
+            int color = Colors[GraphNeighbours[it]];
+            if (color > 0)
+                Blocked.push_back({ color - GraphWeights[it] + 1, color + GraphWeights[it] - 1 });
+        }
+        std::sort(Blocked.begin(), Blocked.end());
+
+        int color = 1;
+        for (const auto& [start, end] : Blocked) {
+            if (start > color)
+                break;
+            color = std::max(color, end + 1);
+        }
+
+        Colors[exam] = color;
+        Span = std::max(Span, color);
+    }
+
+    return Span;
+}
+
+void UETT::ExportTimetable(const std::vector<int>& solution, const std::string& BasePath)
+{
+    std::vector<std::pair<std::string, std::string>> timeIntervals = {
+        {"08:00", "10:00"},
+        {"10:00", "12:00"},
+        {"12:00", "14:00"},
+        {"14:00", "16:00"},
+        {"16:00", "18:00"},
+        {"18:00", "20:00"}
+    };
+
+    std::vector<int> intervals(solution.size());
+    for (auto& interval : intervals)
+        interval = std::rand() % timeIntervals.size();
+
+    {
+        BufferedWriter Fout(BasePath + ".csv");
+        Fout << "Exam,Day,Start,End\n";
+        for (int it = 0; it < (int)solution.size(); ++it)
+            Fout << Exams.Name(it) << ',' << solution[it] << ',' << timeIntervals[intervals[it]].first << ',' << timeIntervals[intervals[it]].second << '\n';
+        Fout.Close();
+    }
+
+    if (Export.Renderer == nullptr)
+        return;
+
+    std::string TempPath = BasePath + ".tmp";
+    {
+        BufferedWriter Fout(TempPath);
+        Fout << '[';
+        for (int it = 0; it < (int)solution.size(); ++it)
+            Fout << (it > 0 ? ", '" : "'") << Exams.Name(it) << '\'';
+        Fout << "]\n[";
+        for (int it = 0; it < (int)solution.size(); ++it)
+            Fout << (it > 0 ? ", " : "") << solution[it];
+        Fout << "]\n[";
+        for (int it = 0; it < (int)solution.size(); ++it)
+            Fout << (it > 0 ? ", '" : "'") << timeIntervals[intervals[it]].first << '\'';
+        Fout << "]\n[";
+        for (int it = 0; it < (int)solution.size(); ++it)
+            Fout << (it > 0 ? ", '" : "'") << timeIntervals[intervals[it]].second << '\'';
+        Fout << "]\n";
+        Fout.Close();
+    }
+    Export.Renderer->Enqueue("Scripts/generate_timetable.py", TempPath);
+}
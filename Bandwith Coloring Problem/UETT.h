@@ -1,38 +1,55 @@
-#pragma once
-
-#include <iostream>
-#include <string>
-#include <map>
-#include <set>
-#include <fstream>
-#include <filesystem>
-#include "json.hpp"
-#include "LPR.h"
-#include "Solver.h"
-
-namespace fs = std::filesystem;
-
-using json = nlohmann::json;
-
-class UETT
-{
-    std::string Path;
-    fs::path OutputPath;
-    fs::path OutputPath_graph;
-    fs::path OutputPath_timetable;
-public:
-    UETT(const std::string& filename);
-
-    void Solve();
-private:
-    std::map<std::string, std::string> Difficulties;
-    std::map<std::string, std::set<std::string>> ExamToStudents;
-    std::map<std::string, std::set<std::string>> Graph;
-    std::map<int, std::string> int_to_str;
-    std::map<std::string, int> str_to_int;
-
-    void ParseJson(const json& j);
-    void CreateGraph();
-    void ComputeTimetableImage(std::vector<int> solution, std::string TempPath);
-};
-
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <set>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <bit>
+#include "UETTReader.h"
+#include "LPR.h"
+#include "Solver.h"
+#include "BatchDriver.h"
+#include "GraphExport.h"
+
+namespace fs = std::filesystem;
+
+class UETT : public BatchJob
+{
+    std::string Path;
+    fs::path OutputPath;
+    fs::path OutputPath_graph;
+    fs::path OutputPath_timetable;
+    RunOptions Options;
+    ExportOptions Export;
+    ThreadPool* Pool = nullptr;
+public:
+    UETT(const std::string& filename, RunOptions Options = {}, ExportOptions Export = {});
+
+    std::string Name() const override;
+    void Load(ThreadPool& Pool) override;
+    int NoReplicas() const override;
+    void SolveReplica(int Replica) override;
+    void WriteOutput() override;
+private:
+    SymbolTable Exams;
+    std::vector<Difficulty> Difficulties;
+    std::vector<int> EnrolmentOffsets;
+    std::vector<int> EnrolmentExams;
+    std::vector<int> GraphOffsets;
+    std::vector<int> GraphNeighbours;
+    std::vector<int> GraphWeights;
+    // Number of students sitting both exams of an edge, in the same order as GraphWeights.
+    std::vector<int> GraphOverlaps;
+    int SpanBound = 0;
+    std::vector<std::vector<int>> Edges;
+    std::vector<std::vector<int>> Solutions;
+
+    void LoadEnrolments(UETTReader& Reader);
+    void CreateGraph(ThreadPool& Pool);
+    int ComputeSpanBound() const;
+    void ExportTimetable(const std::vector<int>& solution, const std::string& BasePath);
+};
+
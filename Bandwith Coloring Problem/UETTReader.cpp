@@ -0,0 +1,150 @@
+#include "UETTReader.h"
+
+bool UETTReader::Read(std::istream& Input)
+{
+    return nlohmann::json::sax_parse(Input, this);
+}
+//------------------------------------------------------------------------------------------------
+
+Difficulty ParseDifficulty(const std::string& Name)
+{
+    if (Name == "easy")
+        return Difficulty::Easy;
+    if (Name == "medium")
+        return Difficulty::Medium;
+    return Difficulty::Hard;
+}
+//------------------------------------------------------------------------------------------------
+
+int UETTReader::InternExam(const std::string& Name)
+{
+    int Id = Exams.Intern(Name);
+    if (Id == (int)Difficulties.size())
+        Difficulties.push_back(Difficulty::Hard);
+    return Id;
+}
+//------------------------------------------------------------------------------------------------
+
+void UETTReader::CloseStudent()
+{
+    if (!InStudent)
+        return;
+
+    EnrolmentOffsets.push_back((int)EnrolmentExams.size());
+    InStudent = false;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::string(string_t& Value)
+{
+    if (Depth == 3)
+    {
+        if (CurrentSection == Section::MandatoryExams)
+        {
+            if (ValueIndex == 0)
+                CurrentExam = InternExam(Value);
+            else if (ValueIndex == 1 && CurrentExam >= 0)
+                Difficulties[CurrentExam] = ParseDifficulty(Value);
+        }
+        else if (CurrentSection == Section::OptionalPacks)
+        {
+            if (ValueIndex == 1)
+            {
+                Difficulty PackDifficulty = ParseDifficulty(Value);
+                for (int Exam : PendingPack)
+                    Difficulties[Exam] = PackDifficulty;
+                PendingPack.clear();
+            }
+        }
+        else if (CurrentSection == Section::Students && InStudent)
+        {
+            EnrolmentExams.push_back(InternExam(Value));
+        }
+        ++ValueIndex;
+    }
+    else if (Depth == 4 && CurrentSection == Section::OptionalPacks)
+    {
+        PendingPack.push_back(InternExam(Value));
+    }
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::key(string_t& Value)
+{
+    if (Depth == 1)
+    {
+        if (Value == "mandatory_exams")
+            CurrentSection = Section::MandatoryExams;
+        else if (Value == "optional_packs")
+            CurrentSection = Section::OptionalPacks;
+        else if (Value == "students")
+            CurrentSection = Section::Students;
+        else
+            CurrentSection = Section::None;
+    }
+    else if (Depth == 2 && CurrentSection == Section::Students)
+    {
+        if (Students.Find(Value) >= 0)
+            throw std::runtime_error("Duplicate student in UETT json: " + Value);
+        CloseStudent();
+        Students.Intern(Value);
+        InStudent = true;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::start_object(std::size_t)
+{
+    ++Depth;
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::end_object()
+{
+    --Depth;
+    if (Depth == 1)
+        CloseStudent();
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::start_array(std::size_t)
+{
+    ++Depth;
+    if (Depth == 3)
+    {
+        ValueIndex = 0;
+        CurrentExam = -1;
+        PendingPack.clear();
+    }
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::end_array()
+{
+    --Depth;
+    if (Depth == 3)
+        ++ValueIndex;
+    else if (Depth == 2)
+        CloseStudent();
+    return true;
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::parse_error(std::size_t Position, const std::string&, const nlohmann::detail::exception& Ex)
+{
+    throw std::runtime_error("Invalid UETT json at byte " + std::to_string(Position) + ": " + Ex.what());
+}
+//------------------------------------------------------------------------------------------------
+
+bool UETTReader::null() { return true; }
+bool UETTReader::boolean(bool) { return true; }
+bool UETTReader::number_integer(number_integer_t) { return true; }
+bool UETTReader::number_unsigned(number_unsigned_t) { return true; }
+bool UETTReader::number_float(number_float_t, const string_t&) { return true; }
+bool UETTReader::binary(binary_t&) { return true; }
+//------------------------------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include "json.hpp"
+#include "SymbolTable.h"
+
+// Numeric value is the minimum separation (in colors) an exam asks for.
+enum class Difficulty : uint8_t
+{
+    Easy = 1,
+    Medium = 2,
+    Hard = 3
+};
+
+Difficulty ParseDifficulty(const std::string& Name);
+
+// Streaming (SAX) reader for the UETT json format. Exam and student names are
+// interned into dense integer ids while the document is parsed, so no DOM is built.
+// Enrolments are stored flat: the exams of student s are
+// EnrolmentExams[EnrolmentOffsets[s] .. EnrolmentOffsets[s + 1]).
+class UETTReader : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    SymbolTable Exams;
+    SymbolTable Students;
+    std::vector<Difficulty> Difficulties;
+    std::vector<int> EnrolmentOffsets = { 0 };
+    std::vector<int> EnrolmentExams;
+
+    bool Read(std::istream& Input);
+
+    bool null() override;
+    bool boolean(bool Value) override;
+    bool number_integer(number_integer_t Value) override;
+    bool number_unsigned(number_unsigned_t Value) override;
+    bool number_float(number_float_t Value, const string_t& Text) override;
+    bool string(string_t& Value) override;
+    bool binary(binary_t& Value) override;
+    bool start_object(std::size_t Elements) override;
+    bool key(string_t& Value) override;
+    bool end_object() override;
+    bool start_array(std::size_t Elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t Position, const std::string& LastToken, const nlohmann::detail::exception& Ex) override;
+
+private:
+    enum class Section { None, MandatoryExams, OptionalPacks, Students };
+
+    Section CurrentSection = Section::None;
+    int Depth = 0;
+    int ValueIndex = 0;
+    int CurrentExam = -1;
+    bool InStudent = false;
+    std::vector<int> PendingPack;
+
+    int InternExam(const std::string& Name);
+    void CloseStudent();
+};